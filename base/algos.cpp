@@ -12,9 +12,616 @@ ArrayAlloc(Arena* arena, u64 capacity)
     return *arr;
 }
 
+// chunked list
+
+template <typename T>
+root_function ChunkList<T>
+ChunkListAlloc(Arena* arena)
+{
+    ChunkList<T> list = {};
+    list.arena = arena;
+    list.chunkCap = Max((CHUNK_LIST_CHUNK_SIZE - CHUNK_LIST_ALIGN) / sizeof(T), 1);
+    return list;
+}
+
+template <typename T>
+root_function T*
+ChunkListPush(ChunkList<T>* list)
+{
+    ChunkListChunk<T>* chunk = list->last;
+    if (IsNull(chunk) || chunk->count == list->chunkCap)
+    {
+        // the header gets its own cache line so the items start on a line boundary
+        static_assert(sizeof(ChunkListChunk<T>) <= CHUNK_LIST_ALIGN, "chunk header too large");
+        u8* mem = (u8*)ArenaPushAlign(list->arena,
+                                      CHUNK_LIST_ALIGN + sizeof(T) * list->chunkCap,
+                                      Max(CHUNK_LIST_ALIGN, AlignOf(T)));
+        chunk = (ChunkListChunk<T>*)mem;
+        chunk->next = 0;
+        chunk->items = (T*)(mem + CHUNK_LIST_ALIGN);
+        chunk->count = 0;
+        chunk->offset = list->count;
+        QueuePush(list->first, list->last, chunk);
+        list->chunkCount++;
+    }
+
+    list->count++;
+    return &chunk->items[chunk->count++];
+}
+
+template <typename T>
+root_function T*
+ChunkListPushZero(ChunkList<T>* list)
+{
+    T* item = ChunkListPush(list);
+    MemoryZeroStruct(item);
+    return item;
+}
+
+// Copies all items to out, which has room for list->count items.
+template <typename T>
+root_function void
+ChunkListCopy(ChunkList<T>* list, T* out)
+{
+    for (ChunkListChunk<T>* chunk = list->first; !IsNull(chunk); chunk = chunk->next)
+    {
+        MemoryCopy(out + chunk->offset, chunk->items, sizeof(T) * chunk->count);
+    }
+}
+
+template <typename T>
+root_function Array<T>
+ChunkListFlatten(Arena* arena, ChunkList<T>* list)
+{
+    Array<T> arr = {};
+    arr.capacity = list->count;
+    arr.data = PushArrayAlign(arena, T, Max(list->count, 1));
+    ChunkListCopy(list, arr.data);
+    return arr;
+}
+
+// Random access to the chunks, to hand them out to worker threads.
+template <typename T>
+root_function Array<ChunkListChunk<T>*>
+ChunkListChunksGet(Arena* arena, ChunkList<T>* list)
+{
+    Array<ChunkListChunk<T>*> chunks = {};
+    chunks.capacity = list->chunkCount;
+    chunks.data = PushArray(arena, ChunkListChunk<T>*, Max(list->chunkCount, 1));
+    u64 chunk_i = 0;
+    for (ChunkListChunk<T>* chunk = list->first; !IsNull(chunk); chunk = chunk->next)
+    {
+        chunks.data[chunk_i++] = chunk;
+    }
+    return chunks;
+}
+
+// murmur3 finalizer, spreads already hashed and sequential values alike
+inline_function u64
+HashFromU64(u64 value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// hash map
+
+inline_function u64
+HashMapKeyHash(u64 key)
+{
+    return HashFromU64(key);
+}
+
+inline_function u64
+HashMapKeyHash(u128 key)
+{
+    return HashMapKeyHash(key.data[0] ^ HashMapKeyHash(key.data[1]));
+}
+
+inline_function b32
+HashMapKeyEqual(u64 a, u64 b)
+{
+    return a == b;
+}
+
+inline_function b32
+HashMapKeyEqual(u128 a, u128 b)
+{
+    return a.data[0] == b.data[0] && a.data[1] == b.data[1];
+}
+
+inline_function u8
+HashMapCtrlFromHash(u64 hash)
+{
+    return (u8)(hash >> 57);
+}
+
+template <typename K, typename V>
+root_function HashMapTable<K, V>
+HashMapTableAlloc(Arena* arena, u64 capacity)
+{
+    HashMapTable<K, V> table = {};
+    table.capacity = HASH_MAP_GROUP_SIZE;
+    while (table.capacity < capacity)
+    {
+        table.capacity *= 2;
+    }
+    table.ctrl = (u8*)ArenaPushAlign(arena, table.capacity + HASH_MAP_GROUP_SIZE,
+                                     HASH_MAP_GROUP_SIZE);
+    MemorySet(table.ctrl, HASH_MAP_CTRL_EMPTY, table.capacity + HASH_MAP_GROUP_SIZE);
+    typedef HashMapSlot<K, V> Slot;
+    table.slots = PushArrayAlign(arena, Slot, table.capacity);
+    return table;
+}
+
+template <typename K, typename V>
+inline_function void
+HashMapCtrlSet(HashMapTable<K, V>* table, u64 slot, u8 ctrl)
+{
+    table->ctrl[slot] = ctrl;
+    if (slot < HASH_MAP_GROUP_SIZE)
+    {
+        table->ctrl[table->capacity + slot] = ctrl;
+    }
+}
+
+template <typename K, typename V>
+root_function b32
+HashMapSlotIsFull(HashMapTable<K, V>* table, u64 slot)
+{
+    return table->ctrl[slot] != HASH_MAP_CTRL_EMPTY;
+}
+
+// Returns the slot holding key, or the first empty slot of its probe chain with found set to 0.
+template <typename K, typename V>
+root_function u64
+HashMapTableProbe(HashMapTable<K, V>* table, K key, u64 hash, b32* found)
+{
+    u64 mask = table->capacity - 1;
+    __m128i ctrlMatch = _mm_set1_epi8((char)HashMapCtrlFromHash(hash));
+    __m128i ctrlEmpty = _mm_set1_epi8((char)HASH_MAP_CTRL_EMPTY);
+    for (u64 pos = hash & mask;; pos = (pos + HASH_MAP_GROUP_SIZE) & mask)
+    {
+        __m128i group = _mm_loadu_si128((__m128i*)(table->ctrl + pos));
+        u32 emptyMask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, ctrlEmpty));
+        // slots past the first empty one belong to other probe chains
+        u32 chainMask = emptyMask ? (emptyMask & (0u - emptyMask)) - 1 : 0xffff;
+        u32 matchMask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, ctrlMatch)) & chainMask;
+        while (matchMask)
+        {
+            u64 slot = (pos + (u64)LSBIndex((i32)matchMask)) & mask;
+            if (HashMapKeyEqual(table->slots[slot].key, key))
+            {
+                *found = 1;
+                return slot;
+            }
+            matchMask &= matchMask - 1;
+        }
+        if (emptyMask)
+        {
+            *found = 0;
+            return (pos + (u64)LSBIndex((i32)emptyMask)) & mask;
+        }
+    }
+}
+
+template <typename K, typename V>
+root_function V*
+HashMapTableInsert(HashMapTable<K, V>* table, u64 slot, K key, u64 hash)
+{
+    HashMapCtrlSet(table, slot, HashMapCtrlFromHash(hash));
+    table->slots[slot].key = key;
+    table->count++;
+    return &table->slots[slot].value;
+}
+
+// Empties a slot and shifts the following entries of the chain back, so no tombstone is needed.
+template <typename K, typename V>
+root_function void
+HashMapTableRemove(HashMapTable<K, V>* table, u64 slot)
+{
+    u64 mask = table->capacity - 1;
+    u64 hole = slot;
+    for (u64 next = (hole + 1) & mask; HashMapSlotIsFull(table, next); next = (next + 1) & mask)
+    {
+        u64 home = HashMapKeyHash(table->slots[next].key) & mask;
+        // an entry may only move back if the hole lies between its home slot and itself
+        b32 stays = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!stays)
+        {
+            HashMapCtrlSet(table, hole, table->ctrl[next]);
+            table->slots[hole] = table->slots[next];
+            hole = next;
+        }
+    }
+    HashMapCtrlSet(table, hole, HASH_MAP_CTRL_EMPTY);
+    table->count--;
+}
+
+template <typename K, typename V>
+root_function void
+HashMapMigrate(HashMap<K, V>* map, u64 slotCount)
+{
+    HashMapTable<K, V>* old = &map->old;
+    for (u64 step = 0; step < slotCount && map->migratePos < old->capacity; step++)
+    {
+        u64 slot = map->migratePos;
+        if (HashMapSlotIsFull(old, slot))
+        {
+            // removing may shift a later entry into this slot, so it is visited again
+            HashMapSlot<K, V>* entry = &old->slots[slot];
+            u64 hash = HashMapKeyHash(entry->key);
+            b32 found;
+            u64 newSlot = HashMapTableProbe(&map->table, entry->key, hash, &found);
+            *HashMapTableInsert(&map->table, newSlot, entry->key, hash) = entry->value;
+            HashMapTableRemove(old, slot);
+        }
+        else
+        {
+            map->migratePos++;
+        }
+    }
+
+    if (map->migratePos == old->capacity)
+    {
+        *old = {};
+        map->migratePos = 0;
+    }
+}
+
+template <typename K, typename V>
+inline_function void
+HashMapProbeRecord(HashMap<K, V>* map, u64 slot, u64 hash)
+{
+    u64 probeLength = ((slot - hash) & (map->table.capacity - 1)) + 1;
+    map->probeStats.lookups++;
+    map->probeStats.probeTotal += probeLength;
+    map->probeStats.probeMax = Max(map->probeStats.probeMax, probeLength);
+}
+
+template <typename K, typename V>
+root_function HashMap<K, V>
+HashMapAlloc(Arena* arena, u64 capacity)
+{
+    HashMap<K, V> map = {};
+    map.arena = arena;
+    map.table = HashMapTableAlloc<K, V>(arena, capacity);
+    return map;
+}
+
+template <typename K, typename V>
+root_function V*
+HashMapFind(HashMap<K, V>* map, K key)
+{
+    u64 hash = HashMapKeyHash(key);
+    b32 found;
+    u64 slot = HashMapTableProbe(&map->table, key, hash, &found);
+    HashMapProbeRecord(map, slot, hash);
+    if (found)
+    {
+        return &map->table.slots[slot].value;
+    }
+    if (map->old.capacity)
+    {
+        slot = HashMapTableProbe(&map->old, key, hash, &found);
+        if (found)
+        {
+            return &map->old.slots[slot].value;
+        }
+    }
+    return 0;
+}
+
+// Returns the value of key, inserting it uninitialized when it is missing.
+template <typename K, typename V>
+root_function V*
+HashMapFindOrInsert(HashMap<K, V>* map, K key, b32* inserted)
+{
+    if (map->old.capacity)
+    {
+        HashMapMigrate(map, HASH_MAP_MIGRATE_STEP);
+    }
+
+    u64 hash = HashMapKeyHash(key);
+    b32 found;
+    u64 slot = HashMapTableProbe(&map->table, key, hash, &found);
+    HashMapProbeRecord(map, slot, hash);
+    if (found)
+    {
+        *inserted = 0;
+        return &map->table.slots[slot].value;
+    }
+
+    V value = {};
+    b32 fromOld = 0;
+    if (map->old.capacity)
+    {
+        u64 oldSlot = HashMapTableProbe(&map->old, key, hash, &found);
+        if (found)
+        {
+            value = map->old.slots[oldSlot].value;
+            HashMapTableRemove(&map->old, oldSlot);
+            fromOld = 1;
+        }
+    }
+
+    // grow at 7/8 load, draining the previous old table first
+    u64 count = map->table.count + map->old.count;
+    if ((count + 1) * 8 > map->table.capacity * 7)
+    {
+        HashMapRehashFinish(map);
+        map->old = map->table;
+        map->table = HashMapTableAlloc<K, V>(map->arena, map->old.capacity * 2);
+        map->migratePos = 0;
+        slot = HashMapTableProbe(&map->table, key, hash, &found);
+    }
+
+    V* result = HashMapTableInsert(&map->table, slot, key, hash);
+    *result = value;
+    *inserted = !fromOld;
+    return result;
+}
+
+template <typename K, typename V>
+root_function V*
+HashMapInsert(HashMap<K, V>* map, K key, V value)
+{
+    b32 inserted;
+    V* result = HashMapFindOrInsert(map, key, &inserted);
+    *result = value;
+    return result;
+}
+
+template <typename K, typename V>
+root_function b32
+HashMapRemove(HashMap<K, V>* map, K key)
+{
+    if (map->old.capacity)
+    {
+        HashMapMigrate(map, HASH_MAP_MIGRATE_STEP);
+    }
+
+    u64 hash = HashMapKeyHash(key);
+    b32 found;
+    u64 slot = HashMapTableProbe(&map->table, key, hash, &found);
+    if (found)
+    {
+        HashMapTableRemove(&map->table, slot);
+        return 1;
+    }
+    if (map->old.capacity)
+    {
+        slot = HashMapTableProbe(&map->old, key, hash, &found);
+        if (found)
+        {
+            HashMapTableRemove(&map->old, slot);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Moves up to slotCount slots of the old table, so a map that stops growing still finishes its
+// rehash without a spike. Meant to be called once per frame.
+template <typename K, typename V>
+root_function void
+HashMapRehashStep(HashMap<K, V>* map, u64 slotCount)
+{
+    if (map->old.capacity)
+    {
+        HashMapMigrate(map, slotCount);
+    }
+}
+
+// Drains the old table, needed before iterating over map->table.
+template <typename K, typename V>
+root_function void
+HashMapRehashFinish(HashMap<K, V>* map)
+{
+    while (map->old.capacity)
+    {
+        HashMapMigrate(map, map->old.capacity);
+    }
+}
+
+template <typename K, typename V>
+root_function u64
+HashMapCount(HashMap<K, V>* map)
+{
+    return map->table.count + map->old.count;
+}
+
+// Empties the map and keeps the table, an old table being drained is dropped.
+template <typename K, typename V>
+root_function void
+HashMapClear(HashMap<K, V>* map)
+{
+    HashMapTable<K, V>* table = &map->table;
+    MemorySet(table->ctrl, HASH_MAP_CTRL_EMPTY, table->capacity + HASH_MAP_GROUP_SIZE);
+    table->count = 0;
+    map->old = {};
+    map->migratePos = 0;
+}
+
+// pool
+
+template <typename T>
+root_function Pool<T>
+PoolAlloc(Arena* arena, u64 blockCount)
+{
+    static_assert(sizeof(T) >= sizeof(PoolFreeNode), "Pool slots must fit a freelist link");
+    Pool<T> pool = {};
+    pool.arena = arena;
+    pool.blockCount = Max(blockCount, 1);
+    return pool;
+}
+
+template <typename T>
+root_function T*
+PoolPush(Pool<T>* pool)
+{
+    if (IsNull(pool->freeList))
+    {
+        T* block = PushArrayAlign(pool->arena, T, pool->blockCount);
+        for (u64 slot_i = pool->blockCount; slot_i > 0; slot_i--)
+        {
+            StackPush(pool->freeList, (PoolFreeNode*)&block[slot_i - 1]);
+        }
+        pool->freeCount += pool->blockCount;
+    }
+
+    T* item = (T*)pool->freeList;
+    StackPop(pool->freeList);
+    pool->freeCount -= 1;
+    pool->liveCount += 1;
+    return item;
+}
+
+template <typename T>
+root_function T*
+PoolPushZero(Pool<T>* pool)
+{
+    T* item = PoolPush(pool);
+    MemoryZeroStruct(item);
+    return item;
+}
+
+template <typename T>
+root_function void
+PoolFree(Pool<T>* pool, T* item)
+{
+    ASSERT(pool->liveCount > 0, "PoolFree: pool has no live items");
+    StackPush(pool->freeList, (PoolFreeNode*)item);
+    pool->liveCount -= 1;
+    pool->freeCount += 1;
+}
+
+template <typename T>
+root_function void
+PoolFreeBatch(Pool<T>* pool, T** items, u64 count)
+{
+    ASSERT(pool->liveCount >= count, "PoolFreeBatch: freeing more items than are live");
+    for (u64 item_i = 0; item_i < count; item_i++)
+    {
+        StackPush(pool->freeList, (PoolFreeNode*)items[item_i]);
+    }
+    pool->liveCount -= count;
+    pool->freeCount += count;
+}
+
 // hash
+// 64x64 -> 128 bit multiply folded back to 64 bits, the mixing step of the short and portable
+// hashes
+inline_function u64
+HashMum(u64 a, u64 b)
+{
+#if defined(_MSC_VER)
+    u64 hi;
+    u64 lo = _umul128(a, b, &hi);
+#else
+    unsigned __int128 product = (unsigned __int128)a * b;
+    u64 lo = (u64)product;
+    u64 hi = (u64)(product >> 64);
+#endif
+    return lo ^ hi;
+}
+
+#define HASH_SECRET_0 0xa0761d6478bd642fULL
+#define HASH_SECRET_1 0xe7037ed1a0b428dbULL
+#define HASH_SECRET_2 0x8ebc6af09c88c6e3ULL
+#define HASH_SECRET_3 0x589965cc75374cc3ULL
+
+inline_function u64
+HashRead64(u8* ptr)
+{
+    u64 value;
+    MemoryCopy(&value, ptr, sizeof(value));
+    return value;
+}
+
+inline_function u64
+HashRead32(u8* ptr)
+{
+    u32 value;
+    MemoryCopy(&value, ptr, sizeof(value));
+    return value;
+}
+
+// Inputs of 16 bytes or less are read as two possibly overlapping words, so there is no byte loop.
+// Longer inputs are folded 16 bytes at a time and finish on the last 16 bytes.
 root_function u128
-HashFromStr8(String8 string)
+HashFromStr8Short(String8 string)
+{
+    u8* ptr = string.str;
+    u64 size = string.size;
+    u64 a = 0;
+    u64 b = 0;
+    u64 seed = HASH_SECRET_0 ^ size;
+    if (size <= 16)
+    {
+        if (size >= 8)
+        {
+            a = HashRead64(ptr);
+            b = HashRead64(ptr + size - 8);
+        }
+        else if (size >= 4)
+        {
+            a = HashRead32(ptr);
+            b = HashRead32(ptr + size - 4);
+        }
+        else if (size > 0)
+        {
+            a = ((u64)ptr[0] << 16) | ((u64)ptr[size >> 1] << 8) | ptr[size - 1];
+        }
+    }
+    else
+    {
+        u8* end = ptr + size;
+        while (end - ptr > 16)
+        {
+            seed = HashMum(HashRead64(ptr) ^ HASH_SECRET_1, HashRead64(ptr + 8) ^ seed);
+            ptr += 16;
+        }
+        a = HashRead64(end - 16);
+        b = HashRead64(end - 8);
+    }
+    u64 lo = HashMum(a ^ HASH_SECRET_1, b ^ seed);
+    u64 hi = HashMum(lo ^ HASH_SECRET_2, size ^ HASH_SECRET_3);
+    return {{HashFromU64(lo ^ hi), hi}};
+}
+
+// Four independent lanes over 64 byte blocks, so the multiplies overlap in the pipeline. Used for
+// bulk data on machines without AES-NI.
+root_function u128
+HashFromStr8Portable(String8 string)
+{
+    u8* ptr = string.str;
+    u64 remaining = string.size;
+    u64 lanes[4] = {HASH_SECRET_0, HASH_SECRET_1, HASH_SECRET_2, HASH_SECRET_3};
+    while (remaining >= 64)
+    {
+        for (u32 lane_i = 0; lane_i < 4; lane_i++)
+        {
+            u8* lane_ptr = ptr + lane_i * 16;
+            lanes[lane_i] = HashMum(HashRead64(lane_ptr) ^ lanes[lane_i],
+                                    HashRead64(lane_ptr + 8) ^ HASH_SECRET_1);
+        }
+        ptr += 64;
+        remaining -= 64;
+    }
+    u64 seed = HashMum(lanes[0] ^ lanes[1], lanes[2] ^ lanes[3]);
+    u128 tail = HashFromStr8Short(Str8(ptr, remaining));
+    u64 lo = HashMum(tail.data[0] ^ seed, string.size ^ HASH_SECRET_2);
+    u64 hi = HashMum(tail.data[1] ^ lanes[0], lanes[3] ^ HASH_SECRET_3);
+    return {{HashFromU64(lo), hi}};
+}
+
+root_function u128
+HashFromStr8Meow(String8 string)
 {
     u128 hash = {0};
     {
@@ -22,4 +629,49 @@ HashFromStr8(String8 string)
         MemoryCopy(&hash, &meow_hash, Min(sizeof(meow_hash), sizeof(hash)));
     }
     return hash;
+}
+
+// cpuid leaf 1, ecx bit 25
+root_function b32
+CPU_AESSupported(void)
+{
+    u32 ecx = 0;
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    ecx = (u32)regs[2];
+#else
+    u32 eax, ebx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return 0;
+    }
+#endif
+    return (ecx & (1u << 25)) != 0;
+}
+
+root_function u128
+HashFromStr8Bulk(String8 string)
+{
+    // Resolved on first use. Every thread computes the same answer, so a racing store is harmless.
+    static HashStr8Func* bulk_func = 0;
+    if (!bulk_func)
+    {
+        bulk_func = CPU_AESSupported() ? HashFromStr8Meow : HashFromStr8Portable;
+    }
+    return bulk_func(string);
+}
+
+root_function u128
+HashFromStr8(String8 string)
+{
+    if (string.size <= HASH_SHORT_MAX)
+    {
+        return HashFromStr8Short(string);
+    }
+    if (string.size < HASH_MEOW_MIN)
+    {
+        return HashFromStr8Portable(string);
+    }
+    return HashFromStr8Bulk(string);
 }
\ No newline at end of file
@@ -1,8 +1,5 @@
 #pragma once
 
-// TODO: Create a array/list that is a mix of a fixed array and a linked list to improve cache
-// utility for some workloads.
-
 // Fixed array
 
 template <typename T> struct Array
@@ -25,6 +22,203 @@ template <typename T>
 root_function Array<T>
 ArrayAlloc(Arena* arena, u64 capacity);
 
+// Chunked list
+// A linked list of fixed size, cache line aligned chunks. Pushing is O(1) and never moves items,
+// iteration walks whole chunks, and the list flattens into contiguous memory with one copy per
+// chunk. Each chunk records the index of its first item, so chunks can be processed in parallel.
+#define CHUNK_LIST_CHUNK_SIZE KILOBYTE(4)
+#define CHUNK_LIST_ALIGN 64
+
+template <typename T> struct ChunkListChunk
+{
+    ChunkListChunk<T>* next;
+    T* items;
+    u64 count;
+    u64 offset; // index of items[0] in the whole list
+};
+
+template <typename T> struct ChunkList
+{
+    Arena* arena;
+    ChunkListChunk<T>* first;
+    ChunkListChunk<T>* last;
+    u64 chunkCap;
+    u64 chunkCount;
+    u64 count;
+};
+
+template <typename T>
+root_function ChunkList<T>
+ChunkListAlloc(Arena* arena);
+
+template <typename T>
+root_function T*
+ChunkListPush(ChunkList<T>* list);
+
+template <typename T>
+root_function T*
+ChunkListPushZero(ChunkList<T>* list);
+
+template <typename T>
+root_function void
+ChunkListCopy(ChunkList<T>* list, T* out);
+
+template <typename T>
+root_function Array<T>
+ChunkListFlatten(Arena* arena, ChunkList<T>* list);
+
+template <typename T>
+root_function Array<ChunkListChunk<T>*>
+ChunkListChunksGet(Arena* arena, ChunkList<T>* list);
+
+// Pool
+// Fixed size slots recycled through a freelist. Slots are taken from the arena a block at a time
+// so recycled objects stay close together even when the arena is shared. A free slot stores the
+// freelist link in its own memory.
+struct PoolFreeNode
+{
+    PoolFreeNode* next;
+};
+
+template <typename T> struct Pool
+{
+    Arena* arena;
+    PoolFreeNode* freeList;
+    u64 blockCount; // slots pushed on the arena when the freelist runs dry
+    u64 liveCount;
+    u64 freeCount;
+};
+
+template <typename T>
+root_function Pool<T>
+PoolAlloc(Arena* arena, u64 blockCount = 32);
+
+template <typename T>
+root_function T*
+PoolPush(Pool<T>* pool);
+
+template <typename T>
+root_function T*
+PoolPushZero(Pool<T>* pool);
+
+template <typename T>
+root_function void
+PoolFree(Pool<T>* pool, T* item);
+
+template <typename T>
+root_function void
+PoolFreeBatch(Pool<T>* pool, T** items, u64 count);
+
 // hashing
+// Strings up to HASH_SHORT_MAX bytes take a short multiply-fold hash, which has no setup cost and
+// no tail loop. Longer ones take the portable four lane hash, and from HASH_MEOW_MIN bytes on Meow
+// when the CPU has AES-NI. bench/hash_bench.cpp measures both crossovers; Meow ties with the
+// portable hash over a range of sizes below HASH_MEOW_MIN and is only taken once it wins clearly.
+#define HASH_SHORT_MAX 63
+#define HASH_MEOW_MIN 512
+
+typedef u128 HashStr8Func(String8 string);
+
+root_function b32
+CPU_AESSupported(void);
+
+root_function u128
+HashFromStr8Short(String8 string);
+
+root_function u128
+HashFromStr8Portable(String8 string);
+
+root_function u128
+HashFromStr8Meow(String8 string);
+
 root_function u128
 HashFromStr8(String8 string);
+
+inline_function u64
+HashFromU64(u64 value);
+
+// Hash map
+// Open addressing with one control byte per slot, probed 16 slots at a time with SSE2. A control
+// byte is HASH_MAP_CTRL_EMPTY or the top 7 bits of the key hash. Probing is linear per slot, so
+// removal shifts the rest of the probe chain back instead of leaving tombstones. The first 16
+// control bytes are mirrored past the end so a group load never has to wrap.
+//
+// Growing is incremental: the full table becomes the old table and each insert or removal moves
+// a few of its slots into the new one. Lookups check both tables until the old one is drained.
+// The old table's memory stays on the arena.
+//
+// Lookups record how many slots they probed in the new table, counted from the key's home slot.
+// The counters only grow; callers read and clear them when they report.
+#define HASH_MAP_GROUP_SIZE 16
+#define HASH_MAP_CTRL_EMPTY ((u8)0x80)
+#define HASH_MAP_MIGRATE_STEP 32
+
+template <typename K, typename V> struct HashMapSlot
+{
+    K key;
+    V value;
+};
+
+template <typename K, typename V> struct HashMapTable
+{
+    u8* ctrl;
+    HashMapSlot<K, V>* slots;
+    u64 capacity; // power of two, at least HASH_MAP_GROUP_SIZE
+    u64 count;
+};
+
+struct HashMapProbeStats
+{
+    u64 lookups;
+    u64 probeTotal; // slots probed over all lookups, a hit in the home slot counts as 1
+    u64 probeMax;
+};
+
+template <typename K, typename V> struct HashMap
+{
+    Arena* arena;
+    HashMapTable<K, V> table;
+    HashMapTable<K, V> old; // being drained into table, capacity 0 when not rehashing
+    u64 migratePos;
+    HashMapProbeStats probeStats;
+};
+
+template <typename K, typename V>
+root_function HashMap<K, V>
+HashMapAlloc(Arena* arena, u64 capacity);
+
+template <typename K, typename V>
+root_function V*
+HashMapFind(HashMap<K, V>* map, K key);
+
+template <typename K, typename V>
+root_function V*
+HashMapFindOrInsert(HashMap<K, V>* map, K key, b32* inserted);
+
+template <typename K, typename V>
+root_function V*
+HashMapInsert(HashMap<K, V>* map, K key, V value);
+
+template <typename K, typename V>
+root_function b32
+HashMapRemove(HashMap<K, V>* map, K key);
+
+template <typename K, typename V>
+root_function void
+HashMapRehashStep(HashMap<K, V>* map, u64 slotCount);
+
+template <typename K, typename V>
+root_function void
+HashMapRehashFinish(HashMap<K, V>* map);
+
+template <typename K, typename V>
+root_function u64
+HashMapCount(HashMap<K, V>* map);
+
+template <typename K, typename V>
+root_function void
+HashMapClear(HashMap<K, V>* map);
+
+template <typename K, typename V>
+root_function b32
+HashMapSlotIsFull(HashMapTable<K, V>* table, u64 slot);
@@ -2,6 +2,8 @@
 #include "algos.cpp"
 #include "algos.hpp"
 #include "core.cpp"
+#include "thread_ctx.cpp"
+#include "work_pool.cpp"
 #ifdef _GNUC_ //TODO: create implementation for windows as well  
 #include "time.cpp"
 #endif
@@ -9,7 +11,7 @@
 #if defined(_MSC_VER)
     #include "os_win.cpp"
 #elif defined(__linux__)
-// TODO: create os folder for linux
+    #include "os_linux.cpp"
 #else
 #error Libraries missing for current OS
 #endif
\ No newline at end of file
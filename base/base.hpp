@@ -5,13 +5,20 @@
 #include <cstdio>
 #include <stdlib.h>
 #include <stdio.h>
+#include <math.h>
 
 #ifdef _WIN64
     #include <windows.h>
     #include <immintrin.h>
+    #include <intrin.h>
 #elif defined(__linux__) 
     #include <sys/time.h>
+    #include <sys/mman.h>
+    #include <pthread.h>
+    #include <semaphore.h>
+    #include <unistd.h>
     #include <x86intrin.h>
+    #include <cpuid.h>
 #else
 # error OS not supported
 #endif
@@ -20,6 +27,7 @@
 #include <cstring>
 #include <cassert>
 #include <cstdarg>
+#include <atomic>
 
 // user defined
 #include "error.hpp"
@@ -32,9 +40,11 @@
 #if defined(_MSC_VER)
     #include "os_win.hpp"
 #elif defined(__linux__)
-// TODO: create os folder for linux
+    #include "os_linux.hpp"
 #else
 #error Libraries missing for current OS
 #endif
+#include "thread_ctx.hpp"
+#include "work_pool.hpp"
 #include "algos.hpp"
 #include "io.hpp"
@@ -1,11 +1,89 @@
 // Arenas
+ArenaRegistry g_arena_registry_local;
+ArenaRegistry* g_arena_registry = &g_arena_registry_local;
+
+no_name_mangle void
+ArenaRegistrySet(ArenaRegistry* registry)
+{
+    g_arena_registry = IsNull(registry) ? &g_arena_registry_local : registry;
+}
+
+inline_function void
+ArenaRegistryLock()
+{
+    while (g_arena_registry->lock.test_and_set(std::memory_order_acquire))
+    {
+        _mm_pause();
+    }
+}
+
+inline_function void
+ArenaRegistryUnlock()
+{
+    g_arena_registry->lock.clear(std::memory_order_release);
+}
+
+// Telemetry counters have a single writer, so a relaxed load and store is enough and keeps
+// the push path free of locked instructions.
+template <typename T>
+inline_function T
+ArenaCounterGet(T* counter)
+{
+    return std::atomic_ref<T>(*counter).load(std::memory_order_relaxed);
+}
+
+template <typename T>
+inline_function void
+ArenaCounterSet(T* counter, T value)
+{
+    std::atomic_ref<T>(*counter).store(value, std::memory_order_relaxed);
+}
+
+template <typename T>
+inline_function void
+ArenaCounterAdd(T* counter, T value)
+{
+    ArenaCounterSet(counter, (T)(ArenaCounterGet(counter) + value));
+}
+
 root_function Arena*
-ArenaAlloc(u64 size)
+ArenaBlockAlloc(u64 size, ArenaFlags flags)
 {
     u64 headerSize = sizeof(Arena);
     u64 cmtSize = OS_PageSize();
-    void* block = OS_Reserve(size);
+    void* block = 0;
+    if (flags & ArenaFlag_LargePages)
+    {
+        cmtSize = OS_LargePageSize();
+        size += cmtSize - 1;
+        size -= size % cmtSize;
+        block = OS_ReserveLarge(size);
+        if (IsNull(block))
+        {
+            flags &= ~(ArenaFlags)ArenaFlag_LargePages;
+            flags |= ArenaFlag_TransparentHugePages;
+        }
+    }
+
+    if (IsNull(block))
+    {
+        if (flags & ArenaFlag_TransparentHugePages)
+        {
+            cmtSize = OS_LargePageSize();
+        }
+        block = OS_Reserve(size);
+        if (flags & ArenaFlag_TransparentHugePages)
+        {
+            OS_HugePagesAdvise(block, size);
+        }
+    }
+
+    cmtSize = Min(cmtSize, size);
     OS_Alloc(block, cmtSize);
+    if (flags & ArenaFlag_Prefault)
+    {
+        OS_Prefault(block, cmtSize);
+    }
     AsanPoisonMemoryRegion(block, cmtSize);
     AsanUnpoisonMemoryRegion(block, headerSize);
 
@@ -15,40 +93,125 @@ ArenaAlloc(u64 size)
     arena->cmtSize = cmtSize;
     arena->cmt = cmtSize;
     arena->align = 8;
+    arena->flags = flags;
+    arena->current = arena;
+    arena->prev = 0;
+    arena->freeLast = 0;
+    arena->basePos = 0;
+    arena->cmtKeep = 0;
+    arena->framePeak = 0;
+    arena->keepFrames = 0;
+    arena->framesBelowKeep = 0;
+    arena->name = 0;
+    arena->registryNext = 0;
+    arena->registryPrev = 0;
+    arena->posPeak = headerSize;
+    arena->pushCount = 0;
+    arena->pushBytes = 0;
+    arena->cmtCalls = 0;
+    arena->decmtCalls = 0;
+    arena->pushBytesLastFrame = 0;
+    arena->cmtCallsLastFrame = 0;
+    arena->decmtCallsLastFrame = 0;
 
     return arena;
 }
 
+root_function Arena*
+ArenaAlloc(u64 size)
+{
+    return ArenaAlloc(size, 0);
+}
+
+root_function Arena*
+ArenaAlloc(u64 size, ArenaFlags flags)
+{
+    Arena* arena = ArenaBlockAlloc(size, flags);
+
+    ArenaRegistryLock();
+    DLLPushBack_NPZ(g_arena_registry->first, g_arena_registry->last, arena, registryNext,
+                    registryPrev, IsNull, SetNull);
+    ArenaRegistryUnlock();
+
+    return arena;
+}
+
+root_function Arena*
+ArenaBlockChain(Arena* arena, u64 size, u64 align)
+{
+    Arena* current = arena->current;
+    u64 sizeNeeded = sizeof(Arena) + size + align;
+    Arena* block = 0;
+
+    // reuse a block released by an earlier pop before reserving a new one
+    for (Arena** freeBlock = &arena->freeLast; !IsNull(*freeBlock);
+         freeBlock = &(*freeBlock)->prev)
+    {
+        if ((*freeBlock)->resSize >= sizeNeeded)
+        {
+            block = *freeBlock;
+            *freeBlock = block->prev;
+            break;
+        }
+    }
+
+    if (IsNull(block))
+    {
+        // grow geometrically so the number of blocks stays logarithmic in the total size
+        u64 resSize = Max(current->resSize * 2, sizeNeeded);
+        block = ArenaBlockAlloc(resSize, arena->flags);
+    }
+
+    block->basePos = current->basePos + current->resSize;
+    block->prev = current;
+    arena->current = block;
+    return block;
+}
+
 root_function void*
 ArenaPushAlign(Arena* arena, u64 size, u64 align)
 {
-    u64 posPre = arena->pos;
-    arena->pos += (align - 1);
-    arena->pos -= arena->pos % align;
-    u64 posPost = arena->pos + size;
-
-    if (posPost > arena->resSize)
+    Arena* current = arena->current;
+    u64 posAligned = current->pos + (align - 1);
+    posAligned -= posAligned % align;
+    if (posAligned + size > current->resSize)
     {
-        exitWithError("Arena Error: Not enough space reserved");
+        if (!(arena->flags & ArenaFlag_Chain))
+        {
+            exitWithError("Arena Error: Not enough space reserved");
+        }
+        current = ArenaBlockChain(arena, size, align);
     }
 
+    u64 posPre = current->pos;
+    current->pos += (align - 1);
+    current->pos -= current->pos % align;
+    u64 posPost = current->pos + size;
+
     // commit memory in new block
-    if (posPost > arena->cmt) {
-        u64 cmtNew = posPost + arena->cmtSize - 1;
-        cmtNew -= cmtNew%arena->cmtSize;
-        u64 cmtNewClamped = Min(cmtNew, arena->resSize);
-        u64 cmtSize = cmtNewClamped - arena->cmt;
-        void* cmtPtr = (void*)((u8*)arena + arena->cmt);
+    if (posPost > current->cmt) {
+        u64 cmtNew = posPost + current->cmtSize - 1;
+        cmtNew -= cmtNew%current->cmtSize;
+        u64 cmtNewClamped = Min(cmtNew, current->resSize);
+        u64 cmtSize = cmtNewClamped - current->cmt;
+        void* cmtPtr = (void*)((u8*)current + current->cmt);
         OS_Alloc(cmtPtr, cmtSize);
-        arena->cmt = cmtNewClamped;
-        AsanPoisonMemoryRegion((u8*)arena+posPost, (arena->cmt-posPost));
+        if (current->flags & ArenaFlag_Prefault)
+        {
+            OS_Prefault(cmtPtr, cmtSize);
+        }
+        current->cmt = cmtNewClamped;
+        ArenaCounterAdd(&arena->cmtCalls, 1u);
+        AsanPoisonMemoryRegion((u8*)current+posPost, (current->cmt-posPost));
     }
 
     // unpoison memory
-    AsanUnpoisonMemoryRegion((u8*)arena+posPre, (posPost - posPre));
+    AsanUnpoisonMemoryRegion((u8*)current+posPre, (posPost - posPre));
     
-    void* result = (void*)((u8*)arena + arena->pos);
-    arena->pos = posPost;
+    void* result = (void*)((u8*)current + current->pos);
+    current->pos = posPost;
+    ArenaCounterAdd(&arena->pushCount, (u64)1);
+    ArenaCounterAdd(&arena->pushBytes, size);
     return result;
 }
 
@@ -75,22 +238,55 @@ ArenaPushZeroAlign(Arena* arena, u64 size, u64 align)
 }
 
 root_function void
-ArenaPop(Arena* arena, u64 pos)
+ArenaBlockPop(Arena* arena, Arena* block, u64 pos)
 {
-    ASSERT(pos<=arena->pos, "ArenaPop: Input position should always be below the current position"); 
-    //uncommit memory
-    u64 unCmtLimit = arena->cmt - arena->cmtSize;
-    if(pos < unCmtLimit) {
-        u64 posCmt = pos + arena->cmtSize - 1;
-        posCmt -= posCmt%arena->cmtSize;
-        u64 unCmtSize = arena->cmt - posCmt;
-        void* posCmtPtr = (void*)((u8*)arena + posCmt);
+    //uncommit memory, but keep everything below the retained position committed
+    u64 keepPos = arena->cmtKeep > block->basePos ? arena->cmtKeep - block->basePos : 0;
+    u64 cmtPos = Max(pos, keepPos);
+    u64 unCmtLimit = block->cmt - block->cmtSize;
+    if(cmtPos < unCmtLimit) {
+        u64 posCmt = cmtPos + block->cmtSize - 1;
+        posCmt -= posCmt%block->cmtSize;
+        u64 unCmtSize = block->cmt - posCmt;
+        void* posCmtPtr = (void*)((u8*)block + posCmt);
         OS_Release(posCmtPtr, unCmtSize);
-        arena->cmt = posCmt;
+        block->cmt = posCmt;
+        ArenaCounterAdd(&arena->decmtCalls, 1u);
     }
 
-    AsanPoisonMemoryRegion((u8*)arena+pos, (arena->pos - pos));
-    arena->pos = pos;
+    AsanPoisonMemoryRegion((u8*)block+pos, (block->pos - pos));
+    block->pos = pos;
+}
+
+root_function void
+ArenaPop(Arena* arena, u64 pos)
+{
+    u64 posCurrent = ArenaPos(arena);
+    ASSERT(pos<=posCurrent, "ArenaPop: Input position should always be below the current position"); 
+    arena->framePeak = Max(arena->framePeak, posCurrent);
+    arena->posPeak = Max(arena->posPeak, posCurrent);
+
+    // blocks that lie entirely above pos go back on the free list
+    Arena* current = arena->current;
+    while (current != arena && current->basePos + sizeof(Arena) > pos)
+    {
+        Arena* prev = current->prev;
+        ArenaBlockPop(arena, current, sizeof(Arena));
+        current->prev = arena->freeLast;
+        arena->freeLast = current;
+        current = prev;
+    }
+    arena->current = current;
+
+    u64 posInBlock = Max(pos - current->basePos, sizeof(Arena));
+    ArenaBlockPop(arena, current, posInBlock);
+}
+
+root_function u64
+ArenaPos(Arena* arena)
+{
+    Arena* current = arena->current;
+    return current->basePos + current->pos;
 }
 
 root_function void
@@ -98,16 +294,165 @@ ArenaReset(Arena* arena) {
     ArenaPop(arena, sizeof(Arena));
 }
 
+root_function void
+ArenaRetainSet(Arena* arena, u32 keepFrames)
+{
+    arena->keepFrames = keepFrames;
+    if (keepFrames == 0)
+    {
+        arena->cmtKeep = 0;
+    }
+}
+
+// Resets an arena that is refilled every frame. With a retention policy set, the highest
+// position reached stays committed for keepFrames frames, after which the retained size decays
+// a quarter of the way towards the current peak per frame. Steady state frames then do not
+// commit or decommit anything.
+root_function void
+ArenaFrameReset(Arena* arena)
+{
+    u64 peak = Max(arena->framePeak, ArenaPos(arena));
+    if (arena->keepFrames > 0)
+    {
+        if (peak >= arena->cmtKeep)
+        {
+            arena->cmtKeep = peak;
+            arena->framesBelowKeep = 0;
+        }
+        else if (++arena->framesBelowKeep > arena->keepFrames)
+        {
+            arena->cmtKeep -= (arena->cmtKeep - peak + 3) / 4;
+        }
+    }
+
+    ArenaReset(arena);
+    arena->framePeak = 0;
+}
+
 root_function void
 ArenaDealloc(Arena* arena)
 {
-    OS_Free((void*)arena);
+    ArenaRegistryLock();
+    DLLRemove_NPZ(g_arena_registry->first, g_arena_registry->last, arena, registryNext,
+                  registryPrev, IsNull, SetNull);
+    ArenaRegistryUnlock();
+
+    for (Arena* block = arena->current; block != arena;)
+    {
+        Arena* prev = block->prev;
+        OS_Free((void*)block, block->resSize);
+        block = prev;
+    }
+    for (Arena* block = arena->freeLast; !IsNull(block);)
+    {
+        Arena* prev = block->prev;
+        OS_Free((void*)block, block->resSize);
+        block = prev;
+    }
+    OS_Free((void*)arena, arena->resSize);
+}
+
+// Telemetry
+root_function void
+ArenaNameSet(Arena* arena, const char* name)
+{
+    arena->name = name;
+}
+
+root_function ArenaTelemetry
+ArenaTelemetryGet(Arena* arena)
+{
+    ArenaTelemetry telemetry = {};
+    telemetry.name = arena->name ? arena->name : "unnamed";
+    telemetry.pos = ArenaPos(arena);
+    telemetry.posPeak = Max(arena->posPeak, telemetry.pos);
+    for (Arena* block = arena->current; !IsNull(block); block = block->prev)
+    {
+        telemetry.cmt += block->cmt;
+        telemetry.res += block->resSize;
+        telemetry.blockCount++;
+    }
+    for (Arena* block = arena->freeLast; !IsNull(block); block = block->prev)
+    {
+        telemetry.cmt += block->cmt;
+        telemetry.res += block->resSize;
+        telemetry.blockCount++;
+    }
+    telemetry.pushCount = ArenaCounterGet(&arena->pushCount);
+    telemetry.pushBytesLastFrame = ArenaCounterGet(&arena->pushBytesLastFrame);
+    telemetry.cmtCallsLastFrame = ArenaCounterGet(&arena->cmtCallsLastFrame);
+    telemetry.decmtCallsLastFrame = ArenaCounterGet(&arena->decmtCallsLastFrame);
+    return telemetry;
+}
+
+// Snapshots every live arena into an array pushed on the given arena.
+root_function ArenaTelemetry*
+ArenaTelemetryList(Arena* arena, u64* count)
+{
+    ArenaRegistryLock();
+    u64 arenaCount = 0;
+    for (Arena* it = g_arena_registry->first; !IsNull(it); it = it->registryNext)
+    {
+        arenaCount++;
+    }
+
+    ArenaTelemetry* list = (ArenaTelemetry*)ArenaPushAlign(
+        arena, sizeof(ArenaTelemetry) * Max(arenaCount, 1), AlignOf(ArenaTelemetry));
+    u64 arena_i = 0;
+    for (Arena* it = g_arena_registry->first; !IsNull(it); it = it->registryNext)
+    {
+        list[arena_i++] = ArenaTelemetryGet(it);
+    }
+    ArenaRegistryUnlock();
+
+    *count = arenaCount;
+    return list;
+}
+
+// Closes the per frame counters of every live arena. Call once per frame from the thread that
+// drives the frame. The totals are only read here, so arenas used by other threads keep counting
+// while this runs and their pushes land in this frame or the next one.
+root_function void
+ArenaRegistryFrameEnd()
+{
+    ArenaRegistryLock();
+    for (Arena* it = g_arena_registry->first; !IsNull(it); it = it->registryNext)
+    {
+        u64 pushBytes = ArenaCounterGet(&it->pushBytes);
+        u32 cmtCalls = ArenaCounterGet(&it->cmtCalls);
+        u32 decmtCalls = ArenaCounterGet(&it->decmtCalls);
+        ArenaCounterSet(&it->pushBytesLastFrame, pushBytes - it->pushBytesFrameStart);
+        ArenaCounterSet(&it->cmtCallsLastFrame, cmtCalls - it->cmtCallsFrameStart);
+        ArenaCounterSet(&it->decmtCallsLastFrame, decmtCalls - it->decmtCallsFrameStart);
+        it->pushBytesFrameStart = pushBytes;
+        it->cmtCallsFrameStart = cmtCalls;
+        it->decmtCallsFrameStart = decmtCalls;
+    }
+    ArenaRegistryUnlock();
+}
+
+root_function void
+ArenaRegistryPrint(FILE* out)
+{
+    fprintf(out, "%-24s %12s %12s %12s %12s %6s %12s %12s %6s %6s\n", "arena", "pos", "peak",
+            "committed", "reserved", "blocks", "pushes", "bytes/frame", "cmt", "decmt");
+    ArenaRegistryLock();
+    for (Arena* it = g_arena_registry->first; !IsNull(it); it = it->registryNext)
+    {
+        ArenaTelemetry t = ArenaTelemetryGet(it);
+        fprintf(out, "%-24s %12llu %12llu %12llu %12llu %6u %12llu %12llu %6u %6u\n", t.name,
+                (unsigned long long)t.pos, (unsigned long long)t.posPeak,
+                (unsigned long long)t.cmt, (unsigned long long)t.res, t.blockCount,
+                (unsigned long long)t.pushCount, (unsigned long long)t.pushBytesLastFrame,
+                t.cmtCallsLastFrame, t.decmtCallsLastFrame);
+    }
+    ArenaRegistryUnlock();
 }
 
 root_function ArenaTemp
 ArenaTempBegin(Arena* arena)
 {
-    ArenaTemp arenaTemp = {arena, arena->pos};
+    ArenaTemp arenaTemp = {arena, ArenaPos(arena)};
     return arenaTemp;
 }
 
@@ -23,18 +23,85 @@ typedef uint64_t b64;
 // function keywords
 #define root_function static
 #define inline_function static inline
+#define no_name_mangle extern "C"
 
 // Scopes
 #define DeferScoped(start, end) for(int _i_ = ((start), 0); _i_ == 0; (_i_ += 1, (end)))
 
 // Arena
+typedef u32 ArenaFlags;
+enum
+{
+    ArenaFlag_LargePages = (1 << 0),           // explicit huge pages, falls back to THP
+    ArenaFlag_TransparentHugePages = (1 << 1), // commit in huge page sized blocks
+    ArenaFlag_Prefault = (1 << 2),             // fault in every block when it is committed
+    ArenaFlag_Chain = (1 << 3),                // link a new, larger block when one fills up
+};
+
+// A chained arena is a list of blocks. The first block is the handle everyone holds and
+// tracks the block pushes currently go to. Positions are global across the chain, so
+// ArenaPos/ArenaPop/ArenaTemp work the same for chained and single block arenas.
 struct Arena
 {
+    Arena* current;  // block pushes go to (first block only)
+    Arena* prev;     // previous block in the chain
+    Arena* freeLast; // popped blocks kept for reuse (first block only)
+    u64 basePos;     // position of this block in the chain
     u64 pos;
     u64 align;
     u64 resSize;
     u64 cmtSize;
     u64 cmt;
+    ArenaFlags flags;
+
+    // commit hysteresis, see ArenaFrameReset (first block only)
+    u64 cmtKeep;           // pops do not decommit below this position
+    u64 framePeak;         // highest position seen by a pop this frame
+    u32 keepFrames;        // frames the peak is kept committed before it decays, 0 disables
+    u32 framesBelowKeep;
+
+    // telemetry, see ArenaTelemetryGet (first block only)
+    const char* name;
+    Arena* registryNext;
+    Arena* registryPrev;
+    // The counters are lifetime totals written only by the thread using the arena. Other
+    // threads read them through ArenaCounterGet, and ArenaRegistryFrameEnd derives the per
+    // frame values from the totals it saw at the previous frame end instead of resetting them.
+    u64 posPeak;           // highest position seen by a pop over the arena's lifetime
+    u64 pushCount;
+    u64 pushBytes;
+    u32 cmtCalls;
+    u32 decmtCalls;
+    u64 pushBytesFrameStart; // written by ArenaRegistryFrameEnd only
+    u32 cmtCallsFrameStart;
+    u32 decmtCallsFrameStart;
+    u64 pushBytesLastFrame;
+    u32 cmtCallsLastFrame;
+    u32 decmtCallsLastFrame;
+};
+
+// Every arena is linked into a process wide registry while it is alive, so usage can be
+// dumped without knowing where each arena is stored. The registry of the application lives in
+// the executable, see ArenaRegistrySet.
+struct ArenaRegistry
+{
+    Arena* first;
+    Arena* last;
+    std::atomic_flag lock;
+};
+
+struct ArenaTelemetry
+{
+    const char* name;
+    u64 pos;
+    u64 posPeak;
+    u64 cmt;
+    u64 res;
+    u32 blockCount;
+    u64 pushCount;
+    u64 pushBytesLastFrame;
+    u32 cmtCallsLastFrame;
+    u32 decmtCallsLastFrame;
 };
 
 struct ArenaTemp
@@ -46,6 +113,9 @@ struct ArenaTemp
 root_function Arena*
 ArenaAlloc(u64 size);
 
+root_function Arena*
+ArenaAlloc(u64 size, ArenaFlags flags);
+
 root_function void
 ArenaDealloc(Arena* arena);
 
@@ -58,9 +128,38 @@ ArenaPushZero(Arena* arena, u64 size);
 root_function void
 ArenaPop(Arena* arena, u64 pos);
 
+root_function u64
+ArenaPos(Arena* arena);
+
 root_function void
 ArenaReset(Arena* arena);
 
+root_function void
+ArenaRetainSet(Arena* arena, u32 keepFrames);
+
+root_function void
+ArenaFrameReset(Arena* arena);
+
+root_function void
+ArenaNameSet(Arena* arena, const char* name);
+
+root_function ArenaTelemetry
+ArenaTelemetryGet(Arena* arena);
+
+root_function ArenaTelemetry*
+ArenaTelemetryList(Arena* arena, u64* count);
+
+// Arenas outlive a reload of the entrypoint library, so the registry linking them must too.
+// Until this is called, or when it is passed null, arenas go into a registry local to the module.
+no_name_mangle void
+ArenaRegistrySet(ArenaRegistry* registry);
+
+root_function void
+ArenaRegistryFrameEnd();
+
+root_function void
+ArenaRegistryPrint(FILE* out);
+
 root_function ArenaTemp
 ArenaTempBegin(Arena* arena);
 
@@ -77,6 +176,9 @@ struct String8
 root_function String8
 Str8(u8* str, u64 size);
 
+// string literal without copying or formatting
+#define Str8Lit(s) Str8((u8*)(s), sizeof(s) - 1)
+
 root_function String8
 Str8Push(Arena* arena, String8 str);
 
@@ -263,7 +365,6 @@ struct Vec3
     }
 };
 
-#define no_name_mangle extern "C"
 // sanitization
 #if ASAN_ENABLED
 #pragma comment(lib, "clang_rt.asan-x86_64.lib")
@@ -276,12 +377,6 @@ no_name_mangle void __asan_unpoison_memory_region(void const volatile *addr, siz
 # define AsanUnpoisonMemoryRegion(addr, size) ((void)(addr), (void)(size))
 #endif
 
-// scratch arena
-root_function ArenaTemp
-ArenaScratchGet();
-root_function ArenaTemp
-ArenaScratchGet(Arena** conflicts, u64 conflict_count);
-
 #define MemoryCopy(dst, src, size) memcpy((dst), (src), (size))
 #define MemorySet(dst, byte, size) memset((dst), (byte), (size))
 
@@ -379,9 +474,11 @@ BufferDec(String8);
 #ifdef __GNUC__
 #define LSBIndex(n) (__builtin_ffs((n)) - 1)
 #define AlignOf(n) __alignof__(n)
+#define per_thread __thread
 #elif defined(_MSC_VER)
 #define LSBIndex(n) (31 - __lzcnt(n))  
 #define AlignOf(n) __alignof(n)  
+#define per_thread __declspec(thread)
 #else
 #error compiler not supported
 #endif
@@ -0,0 +1,206 @@
+// Address space is reserved with PROT_NONE so it costs nothing until it is committed. Committing
+// flips the protection to read/write and decommitting hands the physical pages back with
+// madvise before the range is protected again.
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+root_function u64
+OS_PageSize(void)
+{
+    return (u64)sysconf(_SC_PAGESIZE);
+}
+
+root_function u64
+OS_LargePageSize(void)
+{
+    // default huge page size on x86-64
+    return MEGABYTE(2);
+}
+
+root_function void*
+OS_Reserve(u64 size)
+{
+    void* mappedMem =
+        mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mappedMem == MAP_FAILED)
+    {
+        exitWithError(strerror(errno));
+    }
+    return mappedMem;
+}
+
+// Reserves explicit huge pages from the hugetlbfs pool. The pages are reserved in the pool up
+// front (no MAP_NORESERVE), otherwise an exhausted pool would SIGBUS on first touch instead of
+// failing here. Returns 0 when the pool is too small so the caller can fall back.
+root_function void*
+OS_ReserveLarge(u64 size)
+{
+    u64 largePageSize = OS_LargePageSize();
+    u64 snappedSize = size + largePageSize - 1;
+    snappedSize -= snappedSize % largePageSize;
+    void* mappedMem = mmap(NULL, snappedSize, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mappedMem == MAP_FAILED)
+    {
+        return 0;
+    }
+    return mappedMem;
+}
+
+root_function void
+OS_Alloc(void* ptr, u64 size)
+{
+    if (mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0)
+    {
+        exitWithError("failure when committing memory");
+    }
+}
+
+root_function void
+OS_Free(void* ptr, u64 size)
+{
+    if (munmap(ptr, size) != 0)
+    {
+        exitWithError(strerror(errno));
+    }
+}
+
+root_function void
+OS_Release(void* ptr, u64 size)
+{
+    if (madvise(ptr, size, MADV_DONTNEED) != 0 || mprotect(ptr, size, PROT_NONE) != 0)
+    {
+        exitWithError("memory decommit failed");
+    }
+}
+
+// Asks the kernel to back the range with transparent huge pages. THP can be disabled system
+// wide, so a failure is not an error.
+root_function void
+OS_HugePagesAdvise(void* ptr, u64 size)
+{
+    madvise(ptr, size, MADV_HUGEPAGE);
+}
+
+// Faults in a committed range up front, so the pages are not faulted one at a time on first
+// touch. Kernels older than 5.14 lack MADV_POPULATE_WRITE and get the pages touched instead.
+root_function void
+OS_Prefault(void* ptr, u64 size)
+{
+    if (madvise(ptr, size, MADV_POPULATE_WRITE) != 0)
+    {
+        u64 pageSize = OS_PageSize();
+        for (volatile u8* page = (volatile u8*)ptr; page < (u8*)ptr + size; page += pageSize)
+        {
+            *page = *page;
+        }
+    }
+}
+
+// One exit hook per thread. It runs from a pthread key destructor, so it fires for threads that
+// return or call pthread_exit while their thread locals are still valid.
+struct OS_ThreadExitHook
+{
+    OS_ThreadExitFunc* func;
+    void* data;
+};
+
+per_thread OS_ThreadExitHook os_thread_exit_hook;
+pthread_key_t os_thread_exit_key;
+pthread_once_t os_thread_exit_once = PTHREAD_ONCE_INIT;
+
+root_function void
+OS_ThreadExitHookRun(void* hook_ptr)
+{
+    OS_ThreadExitHook* hook = (OS_ThreadExitHook*)hook_ptr;
+    hook->func(hook->data);
+}
+
+root_function void
+OS_ThreadExitKeyCreate(void)
+{
+    if (pthread_key_create(&os_thread_exit_key, OS_ThreadExitHookRun) != 0)
+    {
+        exitWithError("failed to create thread exit key");
+    }
+}
+
+root_function void
+OS_ThreadExitHookSet(OS_ThreadExitFunc* func, void* data)
+{
+    pthread_once(&os_thread_exit_once, OS_ThreadExitKeyCreate);
+    os_thread_exit_hook.func = func;
+    os_thread_exit_hook.data = data;
+    pthread_setspecific(os_thread_exit_key, &os_thread_exit_hook);
+}
+
+root_function u32
+OS_CoreCount(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+root_function void*
+OS_ThreadEntry(void* thread_ptr)
+{
+    OS_Thread* thread = (OS_Thread*)thread_ptr;
+    thread->func(thread->data);
+    return 0;
+}
+
+// The thread reads func and data through the pointer, so the OS_Thread has to outlive it.
+root_function void
+OS_ThreadStart(OS_Thread* thread, OS_ThreadFunc* func, void* data)
+{
+    thread->func = func;
+    thread->data = data;
+    if (pthread_create(&thread->handle, NULL, OS_ThreadEntry, thread) != 0)
+    {
+        exitWithError("failed to start thread");
+    }
+}
+
+root_function void
+OS_ThreadJoin(OS_Thread* thread)
+{
+    if (pthread_join(thread->handle, NULL) != 0)
+    {
+        exitWithError("failed to join thread");
+    }
+}
+
+root_function void
+OS_SemaphoreAlloc(OS_Semaphore* semaphore, u32 count)
+{
+    if (sem_init(semaphore, 0, count) != 0)
+    {
+        exitWithError(strerror(errno));
+    }
+}
+
+root_function void
+OS_SemaphoreRelease(OS_Semaphore* semaphore)
+{
+    sem_destroy(semaphore);
+}
+
+root_function void
+OS_SemaphoreWait(OS_Semaphore* semaphore)
+{
+    // signals interrupt the wait without taking from the count
+    while (sem_wait(semaphore) != 0 && errno == EINTR)
+    {
+    }
+}
+
+root_function void
+OS_SemaphoreSignal(OS_Semaphore* semaphore, u32 count)
+{
+    for (u32 signal_i = 0; signal_i < count; signal_i++)
+    {
+        sem_post(semaphore);
+    }
+}
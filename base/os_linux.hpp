@@ -1,25 +1,66 @@
-// allocations
+#pragma once
 
-#ifdef __linux__
-#include <sys/mman.h>
+// virtual memory
+root_function u64
+OS_PageSize(void);
+
+root_function u64
+OS_LargePageSize(void);
 
 root_function void*
-memAlloc(u64 size)
-{
-    void* mappedMem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    if (mappedMem == MAP_FAILED)
-    {
-        exitWithError(strerror(errno));
-    }
-    return mappedMem;
-}
+OS_Reserve(u64 size);
+
+root_function void*
+OS_ReserveLarge(u64 size);
+
+root_function void
+OS_Alloc(void* ptr, u64 size);
+
+root_function void
+OS_Free(void* ptr, u64 size);
 
 root_function void
-memFree(void* ptr, u64 freeSize)
+OS_Release(void* ptr, u64 size);
+
+root_function void
+OS_HugePagesAdvise(void* ptr, u64 size);
+
+root_function void
+OS_Prefault(void* ptr, u64 size);
+
+// threads
+typedef void OS_ThreadExitFunc(void* data);
+typedef void OS_ThreadFunc(void* data);
+
+struct OS_Thread
 {
-    if (munmap(ptr, freeSize) < 0)
-    {
-        exitWithError(strerror(errno));
-    }
-}
-#endif
\ No newline at end of file
+    pthread_t handle;
+    OS_ThreadFunc* func;
+    void* data;
+};
+
+typedef sem_t OS_Semaphore;
+
+root_function u32
+OS_CoreCount(void);
+
+root_function void
+OS_ThreadStart(OS_Thread* thread, OS_ThreadFunc* func, void* data);
+
+root_function void
+OS_ThreadJoin(OS_Thread* thread);
+
+root_function void
+OS_SemaphoreAlloc(OS_Semaphore* semaphore, u32 count);
+
+root_function void
+OS_SemaphoreRelease(OS_Semaphore* semaphore);
+
+root_function void
+OS_SemaphoreWait(OS_Semaphore* semaphore);
+
+root_function void
+OS_SemaphoreSignal(OS_Semaphore* semaphore, u32 count);
+
+root_function void
+OS_ThreadExitHookSet(OS_ThreadExitFunc* func, void* data);
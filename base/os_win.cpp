@@ -34,8 +34,9 @@ root_function void OS_Alloc(void* ptr, u64 size)
 }
 
 // Function to free memory
-root_function void OS_Free(void* ptr)
+root_function void OS_Free(void* ptr, u64 size)
 {
+    (void)size; // MEM_RELEASE always frees the whole reservation
     // Free memory using VirtualFree
     if (!VirtualFree(ptr, 0, MEM_RELEASE))
     {
@@ -48,4 +49,115 @@ root_function void OS_Release(void* ptr, u64 size) {
     if(!VirtualFree(ptr, size, MEM_DECOMMIT)){
         exitWithError("memory decommit failed");
     };
-}
\ No newline at end of file
+}
+
+root_function u64
+OS_LargePageSize(void)
+{
+    u64 size = GetLargePageMinimum();
+    return size ? size : OS_PageSize();
+}
+
+// Large pages on windows have to be committed when they are reserved and need the
+// SeLockMemoryPrivilege, which does not fit the reserve/commit scheme of the arenas.
+// Returning 0 makes the caller fall back to regular pages.
+root_function void* OS_ReserveLarge(u64 size) {
+    (void)size;
+    return 0;
+}
+
+root_function void OS_HugePagesAdvise(void* ptr, u64 size) {
+    (void)ptr;
+    (void)size;
+}
+
+root_function void OS_Prefault(void* ptr, u64 size) {
+    u64 pageSize = OS_PageSize();
+    for (volatile u8* page = (volatile u8*)ptr; page < (u8*)ptr + size; page += pageSize)
+    {
+        *page = *page;
+    }
+}
+
+// One exit hook per thread, run by the fiber local storage callback when the thread exits.
+struct OS_ThreadExitHook
+{
+    OS_ThreadExitFunc* func;
+    void* data;
+};
+
+per_thread OS_ThreadExitHook os_thread_exit_hook;
+DWORD os_thread_exit_fls = FLS_OUT_OF_INDEXES;
+INIT_ONCE os_thread_exit_once = INIT_ONCE_STATIC_INIT;
+
+root_function void NTAPI OS_ThreadExitHookRun(void* hook_ptr) {
+    OS_ThreadExitHook* hook = (OS_ThreadExitHook*)hook_ptr;
+    if (hook) {
+        hook->func(hook->data);
+    }
+}
+
+root_function BOOL CALLBACK OS_ThreadExitFlsCreate(PINIT_ONCE once, void* param, void** ctx) {
+    (void)once;
+    (void)param;
+    (void)ctx;
+    os_thread_exit_fls = FlsAlloc(OS_ThreadExitHookRun);
+    return os_thread_exit_fls != FLS_OUT_OF_INDEXES;
+}
+
+root_function void OS_ThreadExitHookSet(OS_ThreadExitFunc* func, void* data) {
+    if (!InitOnceExecuteOnce(&os_thread_exit_once, OS_ThreadExitFlsCreate, 0, 0)) {
+        exitWithError("failed to allocate thread exit slot");
+    }
+    os_thread_exit_hook.func = func;
+    os_thread_exit_hook.data = data;
+    FlsSetValue(os_thread_exit_fls, &os_thread_exit_hook);
+}
+
+root_function u32 OS_CoreCount(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+}
+
+root_function DWORD WINAPI OS_ThreadEntry(void* thread_ptr) {
+    OS_Thread* thread = (OS_Thread*)thread_ptr;
+    thread->func(thread->data);
+    return 0;
+}
+
+// The thread reads func and data through the pointer, so the OS_Thread has to outlive it.
+root_function void OS_ThreadStart(OS_Thread* thread, OS_ThreadFunc* func, void* data) {
+    thread->func = func;
+    thread->data = data;
+    thread->handle = CreateThread(0, 0, OS_ThreadEntry, thread, 0, 0);
+    if (!thread->handle) {
+        exitWithError("failed to start thread");
+    }
+}
+
+root_function void OS_ThreadJoin(OS_Thread* thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+root_function void OS_SemaphoreAlloc(OS_Semaphore* semaphore, u32 count) {
+    *semaphore = CreateSemaphoreA(0, count, LONG_MAX, 0);
+    if (!*semaphore) {
+        exitWithError("failed to create semaphore");
+    }
+}
+
+root_function void OS_SemaphoreRelease(OS_Semaphore* semaphore) {
+    CloseHandle(*semaphore);
+}
+
+root_function void OS_SemaphoreWait(OS_Semaphore* semaphore) {
+    WaitForSingleObject(*semaphore, INFINITE);
+}
+
+root_function void OS_SemaphoreSignal(OS_Semaphore* semaphore, u32 count) {
+    if (count > 0) {
+        ReleaseSemaphore(*semaphore, (LONG)count, 0);
+    }
+}
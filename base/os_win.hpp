@@ -5,6 +5,44 @@ root_function void* OS_Reserve(u64 size);
 
 root_function void OS_Alloc(void* ptr, u64 size);
 
-root_function void OS_Free(void* ptr);
+root_function void OS_Free(void* ptr, u64 size);
 
-root_function void OS_Release(void* ptr, u64 size);
\ No newline at end of file
+root_function void OS_Release(void* ptr, u64 size);
+
+root_function u64
+OS_LargePageSize(void);
+
+root_function void* OS_ReserveLarge(u64 size);
+
+root_function void OS_HugePagesAdvise(void* ptr, u64 size);
+
+root_function void OS_Prefault(void* ptr, u64 size);
+
+// threads
+typedef void OS_ThreadExitFunc(void* data);
+typedef void OS_ThreadFunc(void* data);
+
+struct OS_Thread
+{
+    HANDLE handle;
+    OS_ThreadFunc* func;
+    void* data;
+};
+
+typedef HANDLE OS_Semaphore;
+
+root_function void OS_ThreadExitHookSet(OS_ThreadExitFunc* func, void* data);
+
+root_function u32 OS_CoreCount(void);
+
+root_function void OS_ThreadStart(OS_Thread* thread, OS_ThreadFunc* func, void* data);
+
+root_function void OS_ThreadJoin(OS_Thread* thread);
+
+root_function void OS_SemaphoreAlloc(OS_Semaphore* semaphore, u32 count);
+
+root_function void OS_SemaphoreRelease(OS_Semaphore* semaphore);
+
+root_function void OS_SemaphoreWait(OS_Semaphore* semaphore);
+
+root_function void OS_SemaphoreSignal(OS_Semaphore* semaphore, u32 count);
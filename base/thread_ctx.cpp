@@ -0,0 +1,100 @@
+per_thread ThreadCtx g_thread_ctx_local;
+per_thread ThreadCtx* g_thread_ctx;
+
+root_function void
+ThreadCtxScratchAlloc(ThreadCtx* tctx)
+{
+    u64 size = MEGABYTE(64);
+    for (u32 tctx_i = 0; tctx_i < ArrayCount(tctx->scratchArenas); tctx_i++)
+    {
+        if (IsNull(tctx->scratchArenas[tctx_i]))
+        {
+            tctx->scratchArenas[tctx_i] = ArenaAlloc(size, ArenaFlag_Chain);
+            ArenaNameSet(tctx->scratchArenas[tctx_i], "scratch");
+        }
+    }
+}
+
+root_function void
+ThreadCtxRelease(void* data)
+{
+    ThreadCtx* tctx = (ThreadCtx*)data;
+    for (u32 tctx_i = 0; tctx_i < ArrayCount(tctx->scratchArenas); tctx_i++)
+    {
+        if (!IsNull(tctx->scratchArenas[tctx_i]))
+        {
+            ArenaDealloc(tctx->scratchArenas[tctx_i]);
+            tctx->scratchArenas[tctx_i] = 0;
+        }
+    }
+}
+
+root_function ThreadCtx*
+ThreadCtxGet()
+{
+    ThreadCtx* tctx = g_thread_ctx;
+    if (IsNull(tctx))
+    {
+        tctx = &g_thread_ctx_local;
+        ThreadCtxScratchAlloc(tctx);
+        OS_ThreadExitHookSet(ThreadCtxRelease, tctx);
+        g_thread_ctx = tctx;
+    }
+    return tctx;
+}
+
+// The main thread's context lives in the executable so its scratch arenas survive reloading the
+// entrypoint library.
+no_name_mangle void
+ThreadCxtSet(ThreadCtx* ctx)
+{
+    g_thread_ctx = ctx;
+}
+
+root_function void
+ThreadContextInit()
+{
+    ThreadCtxScratchAlloc(ThreadCtxGet());
+}
+
+root_function void
+ThreadContextExit()
+{
+    ThreadCtxRelease(ThreadCtxGet());
+}
+
+root_function ArenaTemp
+ArenaScratchGet()
+{
+    ThreadCtx* tctx = ThreadCtxGet();
+    ArenaTemp temp = {};
+    temp.pos = ArenaPos(tctx->scratchArenas[0]);
+    temp.arena = tctx->scratchArenas[0];
+    return temp;
+}
+
+root_function ArenaTemp
+ArenaScratchGet(Arena** conflicts, u64 conflict_count)
+{
+    ArenaTemp scratch = {0};
+    ThreadCtx* tctx = ThreadCtxGet();
+    for (u64 tctx_idx = 0; tctx_idx < ArrayCount(tctx->scratchArenas); tctx_idx += 1)
+    {
+        b32 is_conflicting = 0;
+        for (Arena** conflict = conflicts; conflict < conflicts + conflict_count; conflict += 1)
+        {
+            if (*conflict == tctx->scratchArenas[tctx_idx])
+            {
+                is_conflicting = 1;
+                break;
+            }
+        }
+        if (is_conflicting == 0)
+        {
+            scratch.arena = tctx->scratchArenas[tctx_idx];
+            scratch.pos = ArenaPos(scratch.arena);
+            break;
+        }
+    }
+    return scratch;
+}
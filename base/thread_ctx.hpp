@@ -0,0 +1,29 @@
+#pragma once
+
+// Every thread owns a pair of scratch arenas. Two are needed so a function that gets an arena
+// passed in can still take scratch memory that does not alias it, see ArenaScratchGet.
+struct ThreadCtx
+{
+    Arena* scratchArenas[2];
+};
+
+// Threads whose context is not set explicitly get one lazily on first use, released when the
+// thread exits.
+root_function ThreadCtx*
+ThreadCtxGet();
+
+no_name_mangle void
+ThreadCxtSet(ThreadCtx* ctx);
+
+root_function void
+ThreadContextInit();
+
+root_function void
+ThreadContextExit();
+
+// scratch arena
+root_function ArenaTemp
+ArenaScratchGet();
+
+root_function ArenaTemp
+ArenaScratchGet(Arena** conflicts, u64 conflict_count);
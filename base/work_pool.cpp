@@ -0,0 +1,86 @@
+root_function void
+WorkPoolDrain(WorkPool* pool)
+{
+    std::atomic_ref<u64> next(pool->next);
+    for (u64 index = next.fetch_add(1, std::memory_order_relaxed); index < pool->count;
+         index = next.fetch_add(1, std::memory_order_relaxed))
+    {
+        pool->func(pool->data, index);
+    }
+}
+
+root_function void
+WorkPoolWorker(void* data)
+{
+    WorkPool* pool = (WorkPool*)data;
+    for (;;)
+    {
+        OS_SemaphoreWait(&pool->wake);
+        if (std::atomic_ref<u32>(pool->quit).load(std::memory_order_acquire))
+        {
+            break;
+        }
+        WorkPoolDrain(pool);
+        std::atomic_ref<u32>(pool->checkedOut).fetch_add(1, std::memory_order_release);
+    }
+}
+
+root_function void
+WorkPoolStart(WorkPool* pool, u32 threadCount)
+{
+    MemoryZeroStruct(pool);
+    pool->threadCount = Min(threadCount, WorkPool::THREADS_MAX);
+    OS_SemaphoreAlloc(&pool->wake, 0);
+    for (u32 thread_i = 0; thread_i < pool->threadCount; thread_i++)
+    {
+        OS_ThreadStart(&pool->threads[thread_i], WorkPoolWorker, pool);
+    }
+}
+
+root_function void
+WorkPoolStop(WorkPool* pool)
+{
+    std::atomic_ref<u32>(pool->quit).store(1, std::memory_order_release);
+    OS_SemaphoreSignal(&pool->wake, pool->threadCount);
+    for (u32 thread_i = 0; thread_i < pool->threadCount; thread_i++)
+    {
+        OS_ThreadJoin(&pool->threads[thread_i]);
+    }
+    OS_SemaphoreRelease(&pool->wake);
+    pool->threadCount = 0;
+}
+
+// Wakes one worker per item beyond the first, the calling thread takes items too. Every woken
+// worker checks out before this returns, so no worker still reads the batch when the next one is
+// written. Not reentrant: items must not run batches of their own.
+root_function void
+WorkPoolRun(WorkPool* pool, WorkFunc* func, void* data, u64 count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    u32 wakeCount = (u32)Min((u64)pool->threadCount, count - 1);
+    if (wakeCount == 0)
+    {
+        for (u64 index = 0; index < count; index++)
+        {
+            func(data, index);
+        }
+        return;
+    }
+
+    pool->func = func;
+    pool->data = data;
+    pool->count = count;
+    pool->next = 0;
+    pool->checkedOut = 0;
+    // posting the semaphore publishes the batch to the woken workers
+    OS_SemaphoreSignal(&pool->wake, wakeCount);
+    WorkPoolDrain(pool);
+    std::atomic_ref<u32> checkedOut(pool->checkedOut);
+    while (checkedOut.load(std::memory_order_acquire) < wakeCount)
+    {
+        _mm_pause();
+    }
+}
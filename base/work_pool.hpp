@@ -0,0 +1,34 @@
+#pragma once
+
+// A fixed set of worker threads that run batches of independent work items. The thread that
+// runs a batch takes items as well and returns once every item is done, so a batch behaves like
+// a plain loop to the caller. Items are handed out in no particular order, the results must not
+// depend on it.
+typedef void WorkFunc(void* data, u64 index);
+
+struct WorkPool
+{
+    static const u32 THREADS_MAX = 64;
+    OS_Thread threads[THREADS_MAX];
+    u32 threadCount;
+    OS_Semaphore wake;
+    u32 quit;
+
+    // the batch being run, written before the workers are woken
+    WorkFunc* func;
+    void* data;
+    u64 count;
+    u64 next;
+    u32 checkedOut; // woken workers that ran out of items
+};
+
+// The pool is started and stopped in place, so it can live in memory that outlives the code that
+// runs the workers.
+root_function void
+WorkPoolStart(WorkPool* pool, u32 threadCount);
+
+root_function void
+WorkPoolStop(WorkPool* pool);
+
+root_function void
+WorkPoolRun(WorkPool* pool, WorkFunc* func, void* data, u64 count);
@@ -0,0 +1,152 @@
+// Times the string hashes across input sizes and reports where the portable hash starts beating
+// the short one and where Meow starts clearly beating the portable one. HASH_SHORT_MAX and
+// HASH_MEOW_MIN in base/algos.hpp should sit just below and at the reported crossovers.
+#include "base/base.hpp"
+#include "base/base.cpp"
+// the base layer only pulls in the timers under a compiler guard, include them directly
+#include "base/time.hpp"
+#include "base/time.cpp"
+
+#define BENCH_MAX_SIZE 4096
+#define BENCH_BYTES_PER_SIZE MEGABYTE(16)
+#define BENCH_RUNS 31
+#define BENCH_HASH_COUNT 3
+// Meow and the portable hash run within a few percent of each other over a wide range of sizes,
+// where the winner still changes between runs. Meow only counts as faster once it takes less
+// than this share of the portable hash's time.
+#define BENCH_MEOW_MARGIN 0.85
+
+struct HashBench
+{
+    const char* name;
+    HashStr8Func* func;
+};
+
+// Cycles per hash of one timed run. The hash results are folded into a sink so the calls cannot
+// be dropped.
+root_function f64
+HashBenchRun(HashStr8Func* func, u8* data, u64 size, u64* sink)
+{
+    u64 iterations = Max(BENCH_BYTES_PER_SIZE / Max(size, 1), 1024);
+    u64 start = ReadCPUTimer();
+    for (u64 iter_i = 0; iter_i < iterations; iter_i++)
+    {
+        // vary the first byte so every call hashes different input
+        data[0] = (u8)iter_i;
+        u128 hash = func(Str8(data, size));
+        *sink ^= hash.data[0];
+    }
+    return (f64)(ReadCPUTimer() - start) / (f64)iterations;
+}
+
+root_function int
+HashBenchCompare(const void* a, const void* b)
+{
+    f64 x = *(const f64*)a;
+    f64 y = *(const f64*)b;
+    return (x > y) - (x < y);
+}
+
+root_function f64
+HashBenchMedian(f64* values, u32 count)
+{
+    qsort(values, count, sizeof(f64), HashBenchCompare);
+    return values[count / 2];
+}
+
+// Times every hash BENCH_RUNS times, taking turns within each round. cycles gets the median per
+// hash. ratio gets the median over the rounds of each hash's time relative to the hash before it,
+// ratio[0] is unused. Within a round clock changes and other load hit the hashes alike, so the
+// ratio is steadier than a ratio of the medians.
+root_function void
+HashBenchSize(HashBench* benches, u32 bench_count, u8* data, u64 size, u64* sink, f64* cycles,
+              f64* ratio)
+{
+    f64 runs[BENCH_HASH_COUNT][BENCH_RUNS];
+    f64 ratios[BENCH_HASH_COUNT][BENCH_RUNS];
+    for (u32 run_i = 0; run_i < BENCH_RUNS; run_i++)
+    {
+        for (u32 bench_i = 0; bench_i < bench_count; bench_i++)
+        {
+            runs[bench_i][run_i] = HashBenchRun(benches[bench_i].func, data, size, sink);
+            if (bench_i > 0)
+            {
+                ratios[bench_i][run_i] = runs[bench_i][run_i] / runs[bench_i - 1][run_i];
+            }
+        }
+    }
+    for (u32 bench_i = 0; bench_i < bench_count; bench_i++)
+    {
+        cycles[bench_i] = HashBenchMedian(runs[bench_i], BENCH_RUNS);
+        ratio[bench_i] = bench_i > 0 ? HashBenchMedian(ratios[bench_i], BENCH_RUNS) : 1.0;
+    }
+}
+
+int
+main(void)
+{
+    HashBench benches[BENCH_HASH_COUNT] = {
+        {"short", HashFromStr8Short},
+        {"portable", HashFromStr8Portable},
+        {"meow", HashFromStr8Meow},
+    };
+    b32 aes_supported = CPU_AESSupported();
+    u32 bench_count = aes_supported ? ArrayCount(benches) : ArrayCount(benches) - 1;
+
+    u8* data = (u8*)malloc(BENCH_MAX_SIZE);
+    for (u32 byte_i = 0; byte_i < BENCH_MAX_SIZE; byte_i++)
+    {
+        data[byte_i] = (u8)(byte_i * 131 + 7);
+    }
+
+    u64 sink = 0;
+    u64 portable_crossover = ~0ULL;
+    u64 meow_crossover = ~0ULL;
+    printf("aes-ni: %s, timer: %.2f GHz\n", aes_supported ? "yes" : "no",
+           (f64)EstimateCPUTimerFreq() / 1e9);
+    printf("median cycles per hash, then median time relative to the hash before\n");
+    printf("%8s", "bytes");
+    for (u32 bench_i = 0; bench_i < bench_count; bench_i++)
+    {
+        printf("%12s", benches[bench_i].name);
+    }
+    for (u32 bench_i = 1; bench_i < bench_count; bench_i++)
+    {
+        printf("%12s", benches[bench_i].name);
+    }
+    printf("\n");
+
+    u64 sizes[] = {1,  4,  8,  12, 16, 24,  32,  40,  48,   56,   64,  80,
+                   96, 112, 128, 192, 256, 512, 1024, 2048, 4096};
+    for (u32 size_i = 0; size_i < ArrayCount(sizes); size_i++)
+    {
+        u64 size = sizes[size_i];
+        f64 cycles[BENCH_HASH_COUNT] = {};
+        f64 ratio[BENCH_HASH_COUNT] = {};
+        printf("%8llu", (unsigned long long)size);
+        HashBenchSize(benches, bench_count, data, size, &sink, cycles, ratio);
+        for (u32 bench_i = 0; bench_i < bench_count; bench_i++)
+        {
+            printf("%12.1f", cycles[bench_i]);
+        }
+        for (u32 bench_i = 1; bench_i < bench_count; bench_i++)
+        {
+            printf("%12.2f", ratio[bench_i]);
+        }
+        printf("\n");
+        // a crossover is the smallest size from which the faster hash wins at every larger size
+        portable_crossover = ratio[1] < 1.0 ? Min(portable_crossover, size) : ~0ULL;
+        meow_crossover = ratio[2] < BENCH_MEOW_MARGIN ? Min(meow_crossover, size) : ~0ULL;
+    }
+
+    printf("portable hash wins from %llu bytes, HASH_SHORT_MAX is %d\n",
+           (unsigned long long)portable_crossover, HASH_SHORT_MAX);
+    if (aes_supported)
+    {
+        printf("meow wins from %llu bytes, HASH_MEOW_MIN is %d\n",
+               (unsigned long long)meow_crossover, HASH_MEOW_MIN);
+    }
+    printf("sink %llx\n", (unsigned long long)sink);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,14 @@
+#!/bin/bash
+set -e
+
+bench_dir="build/bench"
+exec_name="hash_bench"
+bench_file_name="bench/hash_bench.cpp"
+
+exec_full_path="${bench_dir}/${exec_name}"
+cflags="-std=c++20 -O3 -Wno-write-strings -Wno-unused-result -msse4 -DNDEBUG"
+cwd_ldflags="-I. -I./third_party"
+
+mkdir -p ${bench_dir}
+
+g++ ${cflags} -o ${exec_full_path} ${bench_file_name} ${cwd_ldflags} -lpthread $@
@@ -10,7 +10,7 @@ main_file_name="main.cpp"
 
 exec_full_path="${debug_dir}/${exec_name}"
 entrypoint_lib_full_path="${debug_dir}/${lib_name}"
-cxxflags="-Wall -Wextra -Werror -fsanitize=address -pedantic -Wconversion -Wsign-conversion -Wno-unused-function -Wno-missing-field-initializers -Wno-write-strings -Wno-class-memaccess -Wno-pedantic -maes -msse4"
+cxxflags="-Wall -Wextra -Werror -fsanitize=address -pedantic -Wconversion -Wsign-conversion -Wno-unused-function -Wno-missing-field-initializers -Wno-write-strings -Wno-class-memaccess -Wno-pedantic -msse4"
 cflags="-std=c++20 -g ${cxxflags}"
 cwd_ldflags="-I. -I${stb_include_path}"
 entrypoint_ldflags="-lglfw -lvulkan -lpthread -lX11 -lXxf86vm -lXrandr -lXi -lfreetype  ${cwd_ldflags}"
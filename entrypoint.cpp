@@ -51,32 +51,76 @@ InitContext()
 {
     Context* ctx = GlobalContextGet();
     GlyphAtlas* glyphAtlas = ctx->glyphAtlas;
-    glyphAtlas->fontArena = (Arena*)ArenaAlloc(FONT_ARENA_SIZE);
+    glyphAtlas->fontArena = (Arena*)ArenaAlloc(FONT_ARENA_SIZE, ArenaFlag_Chain);
+    ArenaNameSet(glyphAtlas->fontArena, "fontArena");
+    glyphAtlas->fontPool = PoolAlloc<Font>(glyphAtlas->fontArena, MAX_FONTS_IN_USE);
+    glyphAtlas->fontMap = HashMapAlloc<u64, Font*>(glyphAtlas->fontArena, MAX_FONTS_IN_USE);
+    glyphAtlas->textRunMap = HashMapAlloc<u128, TextRun*>(glyphAtlas->fontArena,
+                                                          GlyphAtlas::TEXT_RUN_CACHE_CAPACITY);
+    glyphAtlas->textRunPool = PoolAlloc<TextRun>(glyphAtlas->fontArena);
 
     UI_State* ui_state = ctx->ui_state;
-    ui_state->arena_permanent = (Arena*)ArenaAlloc(GIGABYTE(1));
-    ui_state->widgetCacheSize = 1; // 4096;
-    ui_state->widgetSlot =
-        PushArray(ui_state->arena_permanent, UI_WidgetSlot, ui_state->widgetCacheSize);
-
-    ui_state->arena_frame = ArenaAlloc(GIGABYTE(1));
+    ArenaFlags ui_arena_flags =
+        ArenaFlag_TransparentHugePages | ArenaFlag_Prefault | ArenaFlag_Chain;
+    ui_state->arena_permanent = (Arena*)ArenaAlloc(MEGABYTE(64), ui_arena_flags);
+    ArenaNameSet(ui_state->arena_permanent, "arena_permanent");
+    ui_state->widgetMap =
+        HashMapAlloc<u64, UI_Widget*>(ui_state->arena_permanent, UI_State::WIDGET_CACHE_CAPACITY);
+    ui_state->widgetPool = PoolAlloc<UI_Widget>(ui_state->arena_permanent);
+    ui_state->pruneGraceFrames = UI_State::WIDGET_PRUNE_GRACE_FRAMES;
+    ui_state->styleTable =
+        UI_StyleTable_Alloc(ui_state->arena_permanent, UI_State::STYLE_TABLE_CAPACITY);
+
+    for (u32 frame_i = 0; frame_i < ArrayCount(ui_state->arena_frames); frame_i++)
+    {
+        Arena* arena_frame = ArenaAlloc(MEGABYTE(64), ui_arena_flags);
+        ArenaNameSet(arena_frame,
+                     (char*)Str8(ui_state->arena_permanent, "arena_frame%u", frame_i).str);
+        ArenaRetainSet(arena_frame, FRAME_ARENA_RETAIN_FRAMES);
+        ui_state->arena_frames[frame_i] = arena_frame;
+    }
+    ui_state->arena_frame = ui_state->arena_frames[0];
 
     ThreadContextInit();
+    WorkersStart();
     initWindow();
     VulkanInit();
 }
 
+// The workers run code from this library, so they are stopped before it is unloaded and started
+// again by the reloaded one.
+no_name_mangle void
+WorkersStart()
+{
+    Context* ctx = GlobalContextGet();
+    WorkPoolStart(&ctx->work_pool, OS_CoreCount() - 1);
+}
+
+no_name_mangle void
+WorkersStop()
+{
+    WorkPoolStop(&GlobalContextGet()->work_pool);
+}
+
 no_name_mangle void
 DeleteContext()
 {
+#ifdef PROFILING_ENABLE
+    // profiling builds report the arenas at shutdown, tools read ArenaTelemetryList instead
+    ArenaRegistryPrint(stdout);
+#endif
     cleanup();
+    WorkersStop();
     ThreadContextExit();
     Context* ctx = GlobalContextGet();
     ASSERT(ctx, "No Global Context found.");
     GlyphAtlas* glyphAtlas = ctx->glyphAtlas;
     UI_State* ui_state = ctx->ui_state;
     ArenaDealloc(glyphAtlas->fontArena);
-    ArenaDealloc(ui_state->arena_frame);
+    for (u32 frame_i = 0; frame_i < ArrayCount(ui_state->arena_frames); frame_i++)
+    {
+        ArenaDealloc(ui_state->arena_frames[frame_i]);
+    }
 }
 
 root_function void
@@ -103,6 +147,14 @@ framebufferResizeCallback(GLFWwindow* window, int width, int height)
     context->vulkanContext->framebufferResized = 1;
 }
 
+root_function void
+scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    auto context = reinterpret_cast<Context*>(glfwGetWindowUserPointer(window));
+    context->io->scrollDelta.x += xoffset;
+    context->io->scrollDelta.y += yoffset;
+}
+
 root_function void
 initWindow()
 {
@@ -115,6 +167,7 @@ initWindow()
     vulkanContext->window = glfwCreateWindow(800, 600, "Vulkan", nullptr, nullptr);
     glfwSetWindowUserPointer(vulkanContext->window, ctx);
     glfwSetFramebufferSizeCallback(vulkanContext->window, framebufferResizeCallback);
+    glfwSetScrollCallback(vulkanContext->window, scrollCallback);
 }
 
 root_function void
@@ -126,7 +179,8 @@ VulkanInit()
     VulkanContext* vulkanContext = ctx->vulkanContext;
     GlyphAtlas* glyphAtlas = ctx->glyphAtlas;
     BoxContext* box_context = ctx->box_context;
-    vulkanContext->arena = ArenaAlloc(GIGABYTE(4));
+    vulkanContext->arena = ArenaAlloc(MEGABYTE(1), ArenaFlag_Chain);
+    ArenaNameSet(vulkanContext->arena, "vulkanContext");
 
     IndexBufferAlloc(vulkanContext, glyphAtlas);
     createInstance(vulkanContext);
@@ -838,6 +892,16 @@ getMaxUsableSampleCount(VkPhysicalDevice device)
     return VK_SAMPLE_COUNT_1_BIT;
 }
 
+root_function void
+EventRowBuild(void* data, u64 row_i)
+{
+    Arena* frame_arena = (Arena*)data;
+    UI_Size semanticSizeX = {.kind = UI_SizeKind_TextContent, .value = 0.0f, .strictness = 0.0f};
+    UI_Size semanticSizeY = {.kind = UI_SizeKind_Null, .value = 0.0f, .strictness = 0.0f};
+    C_Text_SetNext(Str8(frame_arena, "event %llu", (unsigned long long)row_i));
+    UI_Widget_Add(UI_KeyLit("text"), UI_WidgetFlag_DrawText, semanticSizeX, semanticSizeY);
+}
+
 root_function void
 CommandBufferRecord(u32 imageIndex, u32 currentFrame)
 {
@@ -851,8 +915,10 @@ CommandBufferRecord(u32 imageIndex, u32 currentFrame)
     UI_State* ui_state = context->ui_state;
     (void)profilingContext;
 
+    // hit test against the previous frame's grid before its arena can be reset
+    UI_HitTest(ui_state, context->io);
+    UI_State_FrameReset(ui_state, currentFrame);
     Arena* frame_arena = ui_state->arena_frame;
-    UI_State_FrameReset(ui_state);
     FontFrameReset(frame_arena, glyphAtlas);
     BoxFrameReset(frame_arena, box_context);
 
@@ -868,7 +934,7 @@ CommandBufferRecord(u32 imageIndex, u32 currentFrame)
     UI_Size semanticSizeX = {.kind = UI_SizeKind_ChildrenSum, .value = 50.0f, .strictness = 0};
     UI_Size semanticSizeY = {.kind = UI_SizeKind_Null, .value = 0, .strictness = 0};
     {
-        UI_Widget_Add(Str8(frame_arena, "Div"), flags, semanticSizeX, semanticSizeY);
+        UI_Widget_Add(UI_KeyLit("Div"), flags, semanticSizeX, semanticSizeY);
     }
 
     C_FontSize_Scoped(30) UI_Layout_Scoped
@@ -881,16 +947,17 @@ CommandBufferRecord(u32 imageIndex, u32 currentFrame)
         for (u32 btn_i = 0; btn_i < 4; btn_i++)
         {
             color.axis.x += 0.1f;
-            String8 name = Str8(frame_arena, "test_name %u", btn_i);
 
-            C_BackgroundColor_Scoped(color) C_Text_Scoped(Str8(frame_arena, "%u", btn_i))
-                C_FontSize_Scoped(50) UI_Widget_Add(name, flags, semanticSizeX, semanticSizeY);
+            C_BackgroundColor_SetNext(color);
+            C_Text_SetNext(Str8(frame_arena, "%u", btn_i));
+            C_FontSize_SetNext(50);
+            UI_Widget_Add(btn_i, flags, semanticSizeX, semanticSizeY);
         }
 
         semanticSizeX = {.kind = UI_SizeKind_Pixels, .value = 50, .strictness = 0.0f};
         semanticSizeY = {.kind = UI_SizeKind_Pixels, .value = 100, .strictness = 0.0f};
-        String8 name = Str8(frame_arena, "parentSize");
-        UI_Widget_Add(name, 0, semanticSizeX, semanticSizeY);
+        C_ChildLayoutAxis_SetNext(Axis2_Y);
+        UI_Widget_Add(UI_KeyLit("parentSize"), 0, semanticSizeX, semanticSizeY);
 
         UI_Layout_Scoped
         {
@@ -901,24 +968,33 @@ CommandBufferRecord(u32 imageIndex, u32 currentFrame)
                 semanticSizeY = {.kind = UI_SizeKind_PercentOfParent,
                                  .value = 1.0f / childCount,
                                  .strictness = 0.0f};
-                String8 name = Str8(frame_arena, "childOfParent%u", c_i);
                 color = {0.0f, 0.0f, 0.0f, 1.0f};
                 color.data[c_i] = 1.0f;
-                C_BackgroundColor_Scoped(color)
-                    UI_Widget_Add(name, UI_WidgetFlag_DrawBackground, semanticSizeX, semanticSizeY);
+                C_BackgroundColor_SetNext(color);
+                UI_Widget_Add(c_i, UI_WidgetFlag_DrawBackground, semanticSizeX, semanticSizeY);
             }
         }
+
+        semanticSizeX = {.kind = UI_SizeKind_Pixels, .value = 200.0f, .strictness = 0.0f};
+        semanticSizeY = {.kind = UI_SizeKind_Pixels, .value = 200.0f, .strictness = 0.0f};
+        color = {0.2f, 0.2f, 0.2f, 1.0f};
+        C_BackgroundColor_Scoped(color) C_FontSize_Scoped(16)
+            UI_List_Add(UI_KeyLit("events"), UI_WidgetFlag_DrawBackground, semanticSizeX,
+                        semanticSizeY, 1000000, 20.0f, EventRowBuild, frame_arena);
     }
-    UI_Widget_SizeAndRelativePositionCalculate(glyphAtlas, ui_state);
+    UI_LayoutTree_Build(frame_arena, ui_state);
     F32Vec4 rootWindowRect = {0.0f, 0.0f, 400.0f, 400.0f};
-    UI_Widget_AbsolutePositionCalculate(ui_state, rootWindowRect);
-    UI_Widget_DrawPrepare(frame_arena, ui_state, box_context);
+    UI_Layout_Solve(ui_state, &context->work_pool, rootWindowRect);
+    F32Vec4 viewport = {0.0f, 0.0f, (f32)vulkanContext->swapChainExtent.width,
+                        (f32)vulkanContext->swapChainExtent.height};
+    UI_Widget_DrawPrepare(frame_arena, ui_state, viewport);
+    UI_HitGrid_Build(frame_arena, ui_state);
+    UI_Widget_Prune(ui_state);
+    context->io->scrollDelta = {0.0, 0.0};
 
     // recording rectangles
     {
         ZoneScopedN("Rectangle CPU");
-        box_context->numInstances =
-            InstanceBufferFromBoxes(box_context->boxQueue.first, box_context->boxInstances);
         InstanceBufferFillFromBoxes(box_context, vulkanContext->physicalDevice,
                                     vulkanContext->device);
     }
@@ -926,8 +1002,7 @@ CommandBufferRecord(u32 imageIndex, u32 currentFrame)
     {
         ZoneScopedN("Text CPU");
 
-        glyphAtlas->numInstances =
-            InstanceBufferFromFontBuffers(glyphAtlas->glyphInstanceBuffer, glyphAtlas->fontLL);
+        glyphAtlas->numInstances = InstanceBufferFromFontBuffers(glyphAtlas->fontLL);
         mapGlyphInstancesToBuffer(glyphAtlas, vulkanContext->physicalDevice, vulkanContext->device,
                                   vulkanContext->graphicsQueue);
     }
@@ -4,7 +4,8 @@
 #include "base/base.hpp"
 #include "ui/ui.hpp"
 
-const u64 FONT_ARENA_SIZE = MEGABYTE(4);
+const u64 FONT_ARENA_SIZE = KILOBYTE(256);
+const u32 FRAME_ARENA_RETAIN_FRAMES = 120;
 const u32 MAX_FONTS_IN_USE = 10;
 
 extern "C"
@@ -14,6 +15,10 @@ extern "C"
     void
     DeleteContext();
     void
+    WorkersStart();
+    void
+    WorkersStop();
+    void
     drawFrame();
 }
 
@@ -29,6 +34,9 @@ initWindow();
 root_function void
 framebufferResizeCallback(GLFWwindow* window, int width, int height);
 
+root_function void
+scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
+
 root_function void
 CommandBufferRecord(u32 imageIndex, u32 currentFrame);
 
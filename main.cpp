@@ -24,6 +24,8 @@ Context g_ctx_main;
 void (*drawFrameLib)();
 void (*InitContextLib)();
 void (*DeleteContextLib)();
+void (*WorkersStartLib)();
+void (*WorkersStopLib)();
 void (*GlobalContextSetLib)(Context*);
 
 #ifdef __GNUC__
@@ -134,6 +136,20 @@ loadLibrary()
         exit(EXIT_FAILURE);
     }
 
+    WorkersStartLib = (void (*)())dlsym(entryHandle, "WorkersStart");
+    if (!WorkersStartLib)
+    {
+        printf("Failed to load WorkersStart: %s", dlerror());
+        exit(EXIT_FAILURE);
+    }
+
+    WorkersStopLib = (void (*)())dlsym(entryHandle, "WorkersStop");
+    if (!WorkersStopLib)
+    {
+        printf("Failed to load WorkersStop: %s", dlerror());
+        exit(EXIT_FAILURE);
+    }
+
     cleanupLib = (void (*)(Context*))dlsym(entryHandle, "cleanup");
     if (!cleanupLib)
     {
@@ -164,6 +180,13 @@ loadLibrary()
         exit(EXIT_FAILURE);
     }
 
+    GlobalContextSetLib = (void (*)(Context*))dlsym(entryHandle, "GlobalContextSet");
+    if (!GlobalContextSetLib)
+    {
+        printf("Failed to load GlobalContextSet: %s", dlerror());
+        exit(EXIT_FAILURE);
+    }
+
     ThreadContextSetLib = (void (*)(ThreadCtx*))dlsym(entryHandle, "ThreadCxtSet");
     if (!ThreadContextSetLib)
     {
@@ -220,6 +243,7 @@ void
 run()
 {
     ThreadCtx thread_ctx = {0};
+    ArenaRegistry arena_registry = {};
 #ifndef __GNUC__
 #define PROFILING_ENABLE
 #endif
@@ -294,8 +318,8 @@ run()
     UI_IO input = {};
     UI_State ui_state = {};
     UI_Widget g_ui_widget = {&g_ui_widget, &g_ui_widget,&g_ui_widget,&g_ui_widget,&g_ui_widget,&g_ui_widget,&g_ui_widget,0};
-    g_ctx_main = {
-        &vulkanContext, &profilingContext, &glyphAtlas, &rect, &input, &ui_state, &thread_ctx, 0, 0, 0, &g_ui_widget};
+    g_ctx_main = {&vulkanContext, &profilingContext, &glyphAtlas, &rect, &input, &ui_state,
+                  &thread_ctx, &arena_registry, 0, 0, 0, &g_ui_widget};
 
     GlobalContextSetLib(&g_ctx_main);
     InitContextLib();
@@ -313,6 +337,7 @@ run()
         if (libChanged)
         {
             libChanged = false;
+            WorkersStopLib();
             if (dlclose(entryHandle))
             {
                 printf("Failed to close entrypoint.so: %s", dlerror());
@@ -322,6 +347,9 @@ run()
             entryHandle = nullptr;
 
             entryHandle = loadLibrary();
+            // the fresh library starts with empty globals, point them back at the context
+            GlobalContextSetLib(&g_ctx_main);
+            WorkersStartLib();
         }
 
 #endif
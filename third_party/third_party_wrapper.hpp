@@ -23,7 +23,16 @@
 #pragma GCC diagnostic ignored "-Wunused-function"
 #endif
 
+// Meow is compiled for AES-NI on its own so the rest of the build does not need -maes. It is only
+// called once CPU_AESSupported has confirmed the instructions exist.
+#if defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("aes,sse4.2")
 #include "meow_hash_x64_aesni.h"
+#pragma GCC pop_options
+#else
+#include "meow_hash_x64_aesni.h"
+#endif
 #include "stb_sprintf.h"
 // Re-enable warnings for your code
 
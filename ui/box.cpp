@@ -64,11 +64,6 @@ BoxRenderPassBegin(BoxContext* box_context, VulkanContext* vulkanContext, u32 im
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = swapChainExtent;
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
     VkBuffer vertexBuffers[] = {box_context->instBuffer};
     VkDeviceSize offsets[] = {0};
     f32 resolutionData[2] = {(f32)swapChainExtent.width, (f32)swapChainExtent.height};
@@ -79,7 +74,18 @@ BoxRenderPassBegin(BoxContext* box_context, VulkanContext* vulkanContext, u32 im
     vkCmdPushConstants(commandBuffer, box_context->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
                        pushContextInfo.offset, pushContextInfo.size, resolutionData);
 
-    vkCmdDrawIndexed(commandBuffer, 6, static_cast<uint32_t>(box_context->numInstances), 0, 0, 0);
+    for (ChunkListChunk<ScissorBatch>* chunk = box_context->batches.first; !IsNull(chunk);
+         chunk = chunk->next)
+    {
+        for (u64 batch_i = 0; batch_i < chunk->count; batch_i++)
+        {
+            ScissorBatch* batch = &chunk->items[batch_i];
+            VkRect2D scissor = ScissorFromClip(batch->clip, swapChainExtent);
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+            vkCmdDrawIndexed(commandBuffer, 6, (u32)batch->instanceCount, 0, 0,
+                             (u32)batch->instanceOffset);
+        }
+    }
 
     vkCmdEndRenderPass(commandBuffer);
 }
@@ -101,6 +107,7 @@ root_function void
 InstanceBufferFillFromBoxes(BoxContext* box_context, VkPhysicalDevice physicalDevice,
                             VkDevice device)
 {
+    box_context->numInstances = box_context->boxes.count;
     VkDeviceSize bufferSize = sizeof(Vulkan_BoxInstance) * box_context->numInstances;
     if (bufferSize > box_context->instBufferSize)
     {
@@ -117,35 +124,15 @@ InstanceBufferFillFromBoxes(BoxContext* box_context, VkPhysicalDevice physicalDe
 
     void* data;
     vkMapMemory(device, box_context->instMemoryBuffer, 0, bufferSize, 0, &data);
-    MemoryCopy(data, box_context->boxInstances.data, (size_t)bufferSize);
+    ChunkListCopy(&box_context->boxes, (Vulkan_BoxInstance*)data);
     vkUnmapMemory(device, box_context->instMemoryBuffer);
 
     box_context->instBufferSize = bufferSize;
 }
 
-root_function u64
-InstanceBufferFromBoxes(Box* first, Array<Vulkan_BoxInstance> outBuffer)
-{
-    u64 numInstances = 0;
-    for (Box* box = first; !IsNull(box); box = box->next)
-    {
-        outBuffer[numInstances].pos0 = Vec2(box->pos0.x, box->pos0.y);
-        outBuffer[numInstances].pos1 = Vec2(box->pos1.x, box->pos1.y);
-        outBuffer[numInstances].color = {box->color.data[0], box->color.data[1], box->color.data[2],
-                                         box->color.data[3]};
-        outBuffer[numInstances].borderThickness = box->borderThickness;
-        outBuffer[numInstances].cornerRadius = box->cornerRadius;
-        outBuffer[numInstances].softness = box->softness;
-        outBuffer[numInstances].attributes = box->attributes;
-        numInstances++;
-    }
-    return numInstances;
-}
-
 root_function void
 BoxFrameReset(Arena* arena, BoxContext* box_context)
 {
-    box_context->boxInstances =
-        ArrayAlloc<Vulkan_BoxInstance>(arena, box_context->MAX_BOX_INSTANCES);
-    box_context->boxQueue = {0};
+    box_context->boxes = ChunkListAlloc<Vulkan_BoxInstance>(arena);
+    box_context->batches = ChunkListAlloc<ScissorBatch>(arena);
 }
\ No newline at end of file
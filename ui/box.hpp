@@ -69,30 +69,11 @@ struct Vulkan_BoxInstance
     }
 };
 
-struct Box
-{
-    Box* next;
-    Vec2<f32> pos0;
-    Vec2<f32> pos1;
-    F32Vec4 color;
-    f32 softness;
-    f32 borderThickness;
-    f32 cornerRadius;
-    u32 attributes;
-};
-
-struct BoxQueue
-{
-    Box* first;
-    Box* last;
-};
-
 struct BoxContext
 {
-    Array<Vulkan_BoxInstance> boxInstances;
-    BoxQueue boxQueue;
+    ChunkList<Vulkan_BoxInstance> boxes;
+    ChunkList<ScissorBatch> batches;
     u64 numInstances;
-    static const u64 MAX_BOX_INSTANCES = 1000;
 
     // vulkan part
     VkBuffer instBuffer;
@@ -119,8 +100,5 @@ root_function void
 InstanceBufferFillFromBoxes(BoxContext* box_context, VkPhysicalDevice physicalDevice,
                             VkDevice device);
 
-root_function u64
-InstanceBufferFromBoxes(Box* first, Array<Vulkan_BoxInstance> outBuffer);
-
 root_function void
 BoxFrameReset(Arena* arena, BoxContext* box_context);
@@ -48,11 +48,6 @@ GlyphAtlasRenderPass(GlyphAtlas* glyphAtlas, VulkanContext* vulkanContext, u32 i
     viewport.maxDepth = 1.0f;
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = swapChainExtent;
-    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
     VkBuffer vertexBuffers[] = {glyphAtlas->glyphInstBuffer};
     VkDeviceSize offsets[] = {0};
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
@@ -70,8 +65,18 @@ GlyphAtlasRenderPass(GlyphAtlas* glyphAtlas, VulkanContext* vulkanContext, u32 i
         vkCmdPushConstants(commandBuffer, glyphAtlas->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
                            pushConstantInfo.offset, pushConstantInfo.size, resolutionData);
 
-        vkCmdDrawIndexed(commandBuffer, 6, (u32)(font->instanceCount), 0, 0,
-                         (u32)(font->instanceOffset));
+        for (ChunkListChunk<ScissorBatch>* chunk = font->batches.first; !IsNull(chunk);
+             chunk = chunk->next)
+        {
+            for (u64 batch_i = 0; batch_i < chunk->count; batch_i++)
+            {
+                ScissorBatch* batch = &chunk->items[batch_i];
+                VkRect2D scissor = ScissorFromClip(batch->clip, swapChainExtent);
+                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+                vkCmdDrawIndexed(commandBuffer, 6, (u32)batch->instanceCount, 0, 0,
+                                 (u32)(font->instanceOffset + batch->instanceOffset));
+            }
+        }
     }
 
     vkCmdEndRenderPass(commandBuffer);
@@ -102,8 +107,6 @@ TextDimensionsCalculate(Font* font, String8 text)
 root_function void
 TextDraw(Font* font, String8 text, Vec2<f32> pos0, Vec2<f32> pos1)
 {
-    Arena* frame_arena = GlobalContextGet()->ui_state->arena_frame;
-
     // find largest bearing to find origin
     f32 largestBearingY = 0;
     for (u32 textIndex = 0; textIndex < text.size; textIndex++)
@@ -141,8 +144,7 @@ TextDraw(Font* font, String8 text, Vec2<f32> pos0, Vec2<f32> pos1)
         f32 yPosOffset0 =
             Max(-(largestBearingY - ch.bearingY) + ((text_height - (ypos1 - ypos0)) / 2), 0.0f);
 
-        GlyphInstance* glyphInstance = PushStruct(frame_arena, GlyphInstance);
-        StackPush(font->instances, glyphInstance);
+        Vulkan_GlyphInstance* glyphInstance = ChunkListPush(&font->instances);
 
         glyphInstance->pos0 = {xpos0, ypos0};
         glyphInstance->pos1 = {xpos1, ypos1};
@@ -152,24 +154,125 @@ TextDraw(Font* font, String8 text, Vec2<f32> pos0, Vec2<f32> pos1)
     }
 }
 
+// Returns the run of text in font, laid out on first use, or 0 when the text is too long to cache.
+root_function TextRun*
+TextRunFindOrCreate(GlyphAtlas* glyphAtlas, Font* font, String8 text)
+{
+    if (text.size > TextRun::GLYPHS_MAX)
+    {
+        return 0;
+    }
+
+    u128 key = HashFromStr8(text);
+    key.data[0] ^= HashFromU64(font->fontSize);
+    b32 inserted;
+    TextRun** slot = HashMapFindOrInsert(&glyphAtlas->textRunMap, key, &inserted);
+    if (inserted)
+    {
+        TextRun* run = PoolPushZero(&glyphAtlas->textRunPool);
+        run->key = key;
+        run->glyphCount = (u32)text.size;
+
+        f32 largestBearingY = 0;
+        for (u32 i = 0; i < text.size; i++)
+        {
+            if ((u32)text.str[i] >= font->MAX_GLYPHS)
+            {
+                exitWithError("Character not supported!");
+            }
+            largestBearingY = Max(largestBearingY, font->characters[(u64)text.str[i]].bearingY);
+        }
+
+        f32 xOrigin = 0.0f;
+        for (u32 i = 0; i < text.size; i++)
+        {
+            Character* ch = &font->characters[(u64)text.str[i]];
+            TextRunGlyph* glyph = &run->glyphs[i];
+            glyph->pos = {xOrigin + ch->bearingX, largestBearingY - ch->bearingY};
+            glyph->size = {ch->width, ch->height};
+            glyph->glyphOffset = (f32)ch->glyphOffset;
+            xOrigin += (f32)(ch->advance >> 6);
+            run->dimensions.y = Max(run->dimensions.y, ch->height);
+        }
+        run->dimensions.x = xOrigin;
+        *slot = run;
+    }
+
+    TextRun* run = *slot;
+    if (inserted || run->lastFrameUsed != glyphAtlas->frameCount)
+    {
+        run->lastFrameUsed = glyphAtlas->frameCount;
+        if (!inserted)
+        {
+            DLLRemove_NPZ(glyphAtlas->textRunLruFirst, glyphAtlas->textRunLruLast, run, lruNext,
+                          lruPrev, IsNull, SetNull);
+        }
+        DLLPushBack_NPZ(glyphAtlas->textRunLruFirst, glyphAtlas->textRunLruLast, run, lruNext,
+                        lruPrev, IsNull, SetNull);
+    }
+    return run;
+}
+
+// Same placement and clipping as TextDraw, from the positions laid out in the run.
+root_function void
+TextRunDraw(Font* font, TextRun* run, Vec2<f32> pos0, Vec2<f32> pos1)
+{
+    f32 text_height = pos1.y - pos0.y;
+    for (u32 i = 0; i < run->glyphCount; i++)
+    {
+        TextRunGlyph* glyph = &run->glyphs[i];
+        f32 xGlyphPos0 = pos0.x + glyph->pos.x;
+        f32 yGlyphPos0 = pos0.y + glyph->pos.y;
+
+        f32 xPosOffset0 = Max(pos0.x - xGlyphPos0, 0.0f);
+
+        f32 xpos0 = Clamp(xGlyphPos0, pos0.x, pos1.x);
+        f32 ypos0 = Clamp(yGlyphPos0, pos0.y, pos1.y);
+        f32 xpos1 = Clamp(xGlyphPos0 + glyph->size.x, pos0.x, pos1.x);
+        f32 ypos1 = Clamp(yGlyphPos0 + glyph->size.y, pos0.y, pos1.y);
+
+        f32 yPosOffset0 = Max(-glyph->pos.y + ((text_height - (ypos1 - ypos0)) / 2), 0.0f);
+
+        Vulkan_GlyphInstance* glyphInstance = ChunkListPush(&font->instances);
+        glyphInstance->pos0 = {xpos0, ypos0};
+        glyphInstance->pos1 = {xpos1, ypos1};
+        glyphInstance->glyphOffset = {glyph->glyphOffset + xPosOffset0, yPosOffset0};
+    }
+}
+
+// Evicts the runs no widget drew in the last TEXT_RUN_PRUNE_FRAMES frames. Runs only live for
+// the duration of a draw, so this is safe at the start of a frame.
+root_function void
+TextRunPrune(GlyphAtlas* glyphAtlas)
+{
+    u64 pruneCount = 0;
+    while (!IsNull(glyphAtlas->textRunLruFirst))
+    {
+        TextRun* run = glyphAtlas->textRunLruFirst;
+        if (glyphAtlas->frameCount - run->lastFrameUsed <= GlyphAtlas::TEXT_RUN_PRUNE_FRAMES)
+        {
+            break;
+        }
+        DLLRemove_NPZ(glyphAtlas->textRunLruFirst, glyphAtlas->textRunLruLast, run, lruNext,
+                      lruPrev, IsNull, SetNull);
+        HashMapRemove(&glyphAtlas->textRunMap, run->key);
+        PoolFree(&glyphAtlas->textRunPool, run);
+        pruneCount++;
+    }
+    TracyPlot("text runs pruned", (int64_t)pruneCount);
+    TracyPlot("text run cache count", (int64_t)HashMapCount(&glyphAtlas->textRunMap));
+}
+
+// Lays the instances of all fonts out back to back in the instance buffer.
 root_function u64
-InstanceBufferFromFontBuffers(Array<Vulkan_GlyphInstance> outBuffer, FontLL fontLL)
+InstanceBufferFromFontBuffers(FontLL fontLL)
 {
     u64 numInstances = 0;
     for (Font* font = fontLL.first; !IsNull(font); font = font->next)
     {
         font->instanceOffset = numInstances;
-        GlyphInstance* glyphInstanceList = font->instances;
-        for (GlyphInstance* instance = glyphInstanceList; !IsNull(instance);
-             instance = instance->next)
-        {
-            outBuffer[numInstances].pos0 = Vec2(instance->pos0.x, instance->pos0.y);
-            outBuffer[numInstances].pos1 = Vec2(instance->pos1.x, instance->pos1.y);
-            outBuffer[numInstances].glyphOffset =
-                Vec2(instance->glyphOffset.x, instance->glyphOffset.y);
-            numInstances++;
-        }
-        font->instanceCount = numInstances - font->instanceOffset;
+        font->instanceCount = font->instances.count;
+        numInstances += font->instanceCount;
     }
     return numInstances;
 }
@@ -196,7 +299,10 @@ mapGlyphInstancesToBuffer(GlyphAtlas* glyphAtlas, VkPhysicalDevice physicalDevic
 
     void* data;
     vkMapMemory(device, glyphAtlas->glyphMemoryBuffer, 0, bufferSize, 0, &data);
-    MemoryCopy(data, &glyphAtlas->glyphInstanceBuffer[0], (size_t)bufferSize);
+    for (Font* font = glyphAtlas->fontLL.first; !IsNull(font); font = font->next)
+    {
+        ChunkListCopy(&font->instances, (Vulkan_GlyphInstance*)data + font->instanceOffset);
+    }
     vkUnmapMemory(device, glyphAtlas->glyphMemoryBuffer);
 
     glyphAtlas->glyphInstBufferSize = bufferSize;
@@ -222,31 +328,24 @@ createGlyphIndexBuffer(GlyphAtlas* glyphAtlas, VkPhysicalDevice physicalDevice,
 }
 
 root_function Font*
-FontAlloc(Arena* arena, Font* freeList)
+FontAlloc(Pool<Font>* pool)
 {
-    Font* font;
-    if (freeList)
-    {
-        font = freeList;
-        MemoryZeroStruct(font);
-        StackPop(freeList);
-    }
-    else
-    {
-        font = PushStruct(arena, Font);
-    }
-
-    return font;
+    return PoolPushZero(pool);
 }
 
 root_function Font*
 FontInit(GlyphAtlas* glyphAtlas, u32 fontSize)
 {
     Arena* arena = glyphAtlas->fontArena;
-    Font* font = FontAlloc(arena, glyphAtlas->fontFreeList);
+    Font* font = FontAlloc(&glyphAtlas->fontPool);
     font->fontSize = fontSize;
     font->characters = ArrayAlloc<Character>(arena, font->MAX_GLYPHS);
+    // fonts created mid frame take instances right away, FontFrameReset does it for the rest
+    Arena* frame_arena = GlobalContextGet()->ui_state->arena_frame;
+    font->instances = ChunkListAlloc<Vulkan_GlyphInstance>(frame_arena);
+    font->batches = ChunkListAlloc<ScissorBatch>(frame_arena);
     DLLPushBack(glyphAtlas->fontLL.first, glyphAtlas->fontLL.last, font);
+    HashMapInsert(&glyphAtlas->fontMap, (u64)fontSize, font);
     glyphAtlas->fontCount++;
     return font;
 }
@@ -558,21 +657,8 @@ FontDescriptorSetLayoutCreate(VkDevice device, VkDescriptorSetLayout& descriptor
 root_function Font*
 FontFindOrCreate(GlyphAtlas* glyphAtlas, u32 fontSize)
 {
-    bool fontExists = false;
-    Font* font = glyphAtlas->fontLL.first;
-    for (; !IsNull(font); font = font->next)
-    {
-        if (font->fontSize == fontSize)
-        {
-            fontExists = true;
-            break;
-        }
-    }
-
-    if (!fontExists)
-    {
-        font = FontInit(glyphAtlas, fontSize);
-    }
+    Font** fontSlot = HashMapFind(&glyphAtlas->fontMap, (u64)fontSize);
+    Font* font = fontSlot ? *fontSlot : FontInit(glyphAtlas, fontSize);
     ASSERT(font != NULL, "font cannot be null");
     return font;
 }
@@ -595,10 +681,12 @@ FontRenderResourcesAlloc(VulkanContext* vulkanContext, GlyphAtlas* glyphAtlas, F
 root_function void
 FontFrameReset(Arena* arena, GlyphAtlas* glyphAtlas)
 {
-    glyphAtlas->glyphInstanceBuffer =
-        ArrayAlloc<Vulkan_GlyphInstance>(arena, glyphAtlas->MAX_GLYPH_INSTANCES);
     for (Font* font = glyphAtlas->fontLL.first; !IsNull(font); font = font->next)
     {
-        font->instances = 0;
+        font->instances = ChunkListAlloc<Vulkan_GlyphInstance>(arena);
+        font->batches = ChunkListAlloc<ScissorBatch>(arena);
     }
+    glyphAtlas->frameCount++;
+    TextRunPrune(glyphAtlas);
+    HashMapRehashStep(&glyphAtlas->textRunMap, GlyphAtlas::TEXT_RUN_REHASH_STEP);
 }
\ No newline at end of file
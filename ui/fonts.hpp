@@ -57,14 +57,6 @@ struct Vulkan_GlyphInstance
     }
 };
 
-struct GlyphInstance
-{
-    Vec2<f32> pos0;
-    Vec2<f32> pos1;
-    Vec2<f32> glyphOffset;
-    GlyphInstance* next;
-};
-
 struct Font
 {
     Font* next;
@@ -73,7 +65,8 @@ struct Font
 
     u64 instanceOffset;
     u64 instanceCount;
-    GlyphInstance* instances;
+    ChunkList<Vulkan_GlyphInstance> instances;
+    ChunkList<ScissorBatch> batches; // offsets relative to instanceOffset
     Array<Character> characters;
     static const u32 MAX_GLYPHS = 126;
 
@@ -85,6 +78,30 @@ struct Font
     Array<VkDescriptorSet> descriptorSets;
 };
 
+// A string measured and laid out once in one font. Glyph positions are relative to the top left
+// of the text, so labels that do not change are sized and drawn without walking the characters
+// again. Strings longer than GLYPHS_MAX are measured and drawn directly instead.
+struct TextRunGlyph
+{
+    Vec2<f32> pos; // x from the left edge, y down from the largest bearing
+    Vec2<f32> size;
+    f32 glyphOffset;
+};
+
+struct TextRun
+{
+    // use order, least recently drawn first
+    TextRun* lruNext;
+    TextRun* lruPrev;
+    u64 lastFrameUsed;
+
+    u128 key;
+    Vec2<f32> dimensions;
+    u32 glyphCount;
+    static const u32 GLYPHS_MAX = 32;
+    TextRunGlyph glyphs[GLYPHS_MAX];
+};
+
 struct FontLL
 {
     Font* first;
@@ -102,14 +119,24 @@ struct GlyphAtlas
     // persistent arena
     Arena* fontArena;
     FontLL fontLL;
-    Font* fontFreeList;
+    HashMap<u64, Font*> fontMap; // keyed by font size
+    Pool<Font> fontPool;
     u32 fontCount;
     bool loaded;
 
-    Array<Vulkan_GlyphInstance> glyphInstanceBuffer;
+    // text runs of every font keyed by font size and text hash. Runs not used for more than
+    // TEXT_RUN_PRUNE_FRAMES frames are evicted from the front of the use order list.
+    static const u64 TEXT_RUN_CACHE_CAPACITY = 1024;
+    static const u64 TEXT_RUN_REHASH_STEP = 1024;
+    static const u64 TEXT_RUN_PRUNE_FRAMES = 60;
+    HashMap<u128, TextRun*> textRunMap;
+    Pool<TextRun> textRunPool;
+    TextRun* textRunLruFirst;
+    TextRun* textRunLruLast;
+    u64 frameCount;
+
     u64 numInstances;
     u16_Buffer indices;
-    static const u64 MAX_GLYPH_INSTANCES = 1000;
 
     // Vulkan part
     VkBuffer glyphInstBuffer;
@@ -137,8 +164,17 @@ TextDimensionsCalculate(Font* font, String8 text);
 root_function void
 TextDraw(Font* font, String8 text, Vec2<f32> pos0, Vec2<f32> pos1);
 
+root_function TextRun*
+TextRunFindOrCreate(GlyphAtlas* glyphAtlas, Font* font, String8 text);
+
+root_function void
+TextRunDraw(Font* font, TextRun* run, Vec2<f32> pos0, Vec2<f32> pos1);
+
+root_function void
+TextRunPrune(GlyphAtlas* glyphAtlas);
+
 root_function u64
-InstanceBufferFromFontBuffers(Array<Vulkan_GlyphInstance> outBuffer, FontLL fontLL);
+InstanceBufferFromFontBuffers(FontLL fontLL);
 
 root_function void
 mapGlyphInstancesToBuffer(GlyphAtlas* glyphAtlas, VkPhysicalDevice physicalDevice, VkDevice device,
@@ -148,7 +184,7 @@ root_function void
 createGlyphIndexBuffer(GlyphAtlas* glyphAtlas, VkPhysicalDevice physicalDevice, VkDevice device);
 
 root_function Font*
-FontAlloc(Arena* arena, Font* freeList);
+FontAlloc(Pool<Font>* pool);
 
 root_function Font*
 FontInit(GlyphAtlas* glyphAtlas, u32 fontSize);
@@ -1,43 +1,32 @@
 #pragma once
 
-// tread context
-#ifdef __linux__
-#define per_thread __thread
-#elif defined(_MSC_VER)
-#define per_thread __declspec(thread)
-#else
-#error thread context not implemented for os
-#endif
-
 // Widget Configuration --------------------------------
 
-#define X(name, type) \
+#define X(name, type, default) \
     inline_function type name##_Get();
 WidgetCfg
 #undef X
 
-#define X(name, type) \
+#define X(name, type, default) \
     inline_function void name##_Push(type v);
 WidgetCfg
 #undef X
 
-#define X(name, type) \
+#define X(name, type, default) \
     inline_function void name##_Pop();
 WidgetCfg
 #undef X
 
+#define X(name, type, default) \
+    inline_function void name##_SetNext(type v);
+WidgetCfg
+#undef X
 
-root_function void
-ThreadContextInit();
-
-root_function void
-ThreadContextExit();
-
-no_name_mangle void
-ThreadCxtSet(ThreadCtx* ctx);
+inline_function void
+UI_ConfigAutoPop(UI_ConfigStacks* stacks);
+inline_function void
+UI_ConfigReset(UI_ConfigStacks* stacks);
 
-root_function ThreadCtx* 
-ThreadCtxGet();
 
 // globals context
 no_name_mangle void GlobalContextSet(Context* ctx);
@@ -0,0 +1,163 @@
+// Targets are hit in the part left visible by their Clip ancestors, widgets scrolled or clipped
+// out of view are no targets at all.
+inline_function b32
+UI_HitTarget(UI_LayoutTree* layout, u32 index)
+{
+    UI_Widget* widget = layout->widget[index];
+    return (widget->flags & (UI_WidgetFlag_Clickable | UI_WidgetFlag_DrawBackground)) != 0 &&
+           !UI_RectIsEmpty(layout->visible[index]);
+}
+
+inline_function u32
+UI_HitGrid_Cell(UI_HitGrid* grid, f32 position, f32 origin, u32 cellCount)
+{
+    f32 cell = (position - origin) / grid->cellSize;
+    return (u32)Clamp(cell, 0.0f, (f32)(cellCount - 1));
+}
+
+// Built from this frame's visible rects once UI_Widget_DrawPrepare has clipped them and queried
+// at the start of the next frame, so the arena has to outlive the frame, like the frame arena
+// does.
+root_function void
+UI_HitGrid_Build(Arena* arena, UI_State* ui_state)
+{
+    ZoneScoped;
+    UI_LayoutTree* layout = &ui_state->layout;
+    UI_HitGrid* grid = &ui_state->hitGrid;
+    *grid = {};
+    ASSERT(layout->count == 0 || layout->visible, "Build the hit grid after UI_Widget_DrawPrepare");
+
+    Vec2<f32> boundsMin = {0.0f, 0.0f};
+    Vec2<f32> boundsMax = {0.0f, 0.0f};
+    u32 targetCount = 0;
+    for (u32 index = 0; index < layout->count; index++)
+    {
+        if (UI_HitTarget(layout, index))
+        {
+            F32Vec4 rect = layout->visible[index];
+            if (targetCount == 0)
+            {
+                boundsMin = rect.point.p0;
+                boundsMax = rect.point.p1;
+            }
+            for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+            {
+                boundsMin[axis] = Min(boundsMin[axis], rect.point.p0[axis]);
+                boundsMax[axis] = Max(boundsMax[axis], rect.point.p1[axis]);
+            }
+            targetCount++;
+        }
+    }
+    if (targetCount == 0)
+    {
+        return;
+    }
+
+    Vec2<f32> extent = boundsMax - boundsMin;
+    grid->origin = boundsMin;
+    grid->cellSize = Max(UI_State::HIT_GRID_CELL_SIZE,
+                         Max(extent.x, extent.y) / (f32)UI_State::HIT_GRID_CELLS_MAX);
+    grid->cellCountX = (u32)(extent.x / grid->cellSize) + 1;
+    grid->cellCountY = (u32)(extent.y / grid->cellSize) + 1;
+    u32 cellCount = grid->cellCountX * grid->cellCountY;
+    grid->cellStart = PushArrayZero(arena, u32, cellCount + 1);
+
+    // counting sort: count the targets per cell, turn the counts into offsets, then fill the
+    // cells in pre-order, which is the draw order
+    ArenaTemp scratch = ArenaScratchGet(&arena, 1);
+    u32* cellRange = PushArray(scratch.arena, u32, (u64)targetCount * 4);
+    u32 target_i = 0;
+    for (u32 index = 0; index < layout->count; index++)
+    {
+        if (UI_HitTarget(layout, index))
+        {
+            F32Vec4 rect = layout->visible[index];
+            u32* range = &cellRange[target_i++ * 4];
+            range[0] = UI_HitGrid_Cell(grid, rect.point.p0.x, grid->origin.x, grid->cellCountX);
+            range[1] = UI_HitGrid_Cell(grid, rect.point.p0.y, grid->origin.y, grid->cellCountY);
+            range[2] = UI_HitGrid_Cell(grid, rect.point.p1.x, grid->origin.x, grid->cellCountX);
+            range[3] = UI_HitGrid_Cell(grid, rect.point.p1.y, grid->origin.y, grid->cellCountY);
+            for (u32 cellY = range[1]; cellY <= range[3]; cellY++)
+            {
+                for (u32 cellX = range[0]; cellX <= range[2]; cellX++)
+                {
+                    grid->cellStart[cellY * grid->cellCountX + cellX + 1]++;
+                }
+            }
+        }
+    }
+    for (u32 cell = 0; cell < cellCount; cell++)
+    {
+        grid->cellStart[cell + 1] += grid->cellStart[cell];
+    }
+
+    grid->entries = PushArray(arena, UI_HitEntry, grid->cellStart[cellCount]);
+    u32* cellFill = PushArray(scratch.arena, u32, cellCount);
+    MemoryCopy(cellFill, grid->cellStart, sizeof(u32) * cellCount);
+    target_i = 0;
+    for (u32 index = 0; index < layout->count; index++)
+    {
+        if (UI_HitTarget(layout, index))
+        {
+            UI_HitEntry entry = {layout->visible[index], layout->widget[index]->key};
+            u32* range = &cellRange[target_i++ * 4];
+            for (u32 cellY = range[1]; cellY <= range[3]; cellY++)
+            {
+                for (u32 cellX = range[0]; cellX <= range[2]; cellX++)
+                {
+                    u32 cell = cellY * grid->cellCountX + cellX;
+                    grid->entries[cellFill[cell]++] = entry;
+                }
+            }
+        }
+    }
+    ArenaTempEnd(scratch);
+    TracyPlot("hit grid entries", (int64_t)grid->cellStart[cellCount]);
+}
+
+root_function UI_Key
+UI_HitGrid_Query(UI_HitGrid* grid, Vec2<f32> point)
+{
+    UI_Key key = {0};
+    if (grid->cellCountX == 0 || point.x < grid->origin.x || point.y < grid->origin.y)
+    {
+        return key;
+    }
+    u32 cellX = (u32)((point.x - grid->origin.x) / grid->cellSize);
+    u32 cellY = (u32)((point.y - grid->origin.y) / grid->cellSize);
+    if (cellX >= grid->cellCountX || cellY >= grid->cellCountY)
+    {
+        return key;
+    }
+
+    u32 cell = cellY * grid->cellCountX + cellX;
+    for (u32 entry_i = grid->cellStart[cell + 1]; entry_i-- > grid->cellStart[cell];)
+    {
+        UI_HitEntry* entry = &grid->entries[entry_i];
+        if (point >= entry->rect.point.p0 && point <= entry->rect.point.p1)
+        {
+            key = entry->key;
+            break;
+        }
+    }
+    return key;
+}
+
+// Runs once per frame before the widgets are declared, against the grid of the previous frame.
+// The active widget is the one the button went down on, it stays active until the button is
+// released even when the mouse leaves it.
+root_function void
+UI_HitTest(UI_State* ui_state, UI_IO* io)
+{
+    Vec2<f32> mousePosition = {(f32)io->mousePosition.x, (f32)io->mousePosition.y};
+    ui_state->hotKey = UI_HitGrid_Query(&ui_state->hitGrid, mousePosition);
+    if (!io->leftClicked)
+    {
+        ui_state->activeKey = {0};
+    }
+    else if (!ui_state->leftClickedPrev)
+    {
+        ui_state->activeKey = ui_state->hotKey;
+    }
+    ui_state->leftClickedPrev = io->leftClicked;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+root_function void
+UI_HitGrid_Build(Arena* arena, UI_State* ui_state);
+
+root_function UI_Key
+UI_HitGrid_Query(UI_HitGrid* grid, Vec2<f32> point);
+
+root_function void
+UI_HitTest(UI_State* ui_state, UI_IO* io);
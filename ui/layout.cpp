@@ -0,0 +1,534 @@
+// Layout runs over the pre-order columns of UI_LayoutTree, see state.hpp for the passes.
+
+inline_function u64
+UI_LayoutHashF32(u64 hash, f32 value)
+{
+    u32 bits;
+    MemoryCopy(&bits, &value, sizeof(bits));
+    return HashFromU64(hash ^ bits);
+}
+
+// Everything the solver reads from one widget: its key, semantic sizes, child layout axis and
+// offset and, when it is sized by its text, the text and the style that pads it.
+root_function u64
+UI_Widget_LayoutInputHash(UI_Widget* widget)
+{
+    u64 hash = HashFromU64(widget->key.key ^ (u64)widget->childLayoutAxis);
+    b32 textContent = 0;
+    for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+    {
+        hash = UI_LayoutHashF32(hash, widget->childOffset[axis]);
+        UI_Size size = widget->semanticSize[axis];
+        hash = HashFromU64(hash ^ (u64)size.kind);
+        hash = UI_LayoutHashF32(hash, size.value);
+        hash = UI_LayoutHashF32(hash, size.strictness);
+        textContent |= size.kind == UI_SizeKind_TextContent;
+    }
+    if (textContent)
+    {
+        // the style fields and not the id, ids are reassigned when the style table is reset
+        UI_TextExtData* data = (UI_TextExtData*)widget->text_ext->data;
+        UI_Style* style = UI_Style_FromId(&GlobalContextGet()->ui_state->styleTable, widget->style);
+        hash = HashFromU64(hash ^ HashFromStr8(data->text).data[0]);
+        hash = HashFromU64(hash ^ style->font_size);
+        hash = UI_LayoutHashF32(hash, style->border_thickness);
+        for (u32 i = 0; i < 4; i++)
+        {
+            hash = UI_LayoutHashF32(hash, style->padding.data[i]);
+            hash = UI_LayoutHashF32(hash, style->margin.data[i]);
+        }
+    }
+    // 0 is the hash of a widget that was never laid out
+    return hash + (hash == 0);
+}
+
+// A Null axis fills the parent when the other axis is a percentage of it.
+inline_function b32
+UI_Layout_FillsParent(UI_LayoutTree* layout, u32 index, u32 axis)
+{
+    u32 otherAx = (axis + 1) % Axis2_COUNT;
+    return layout->semanticSize[axis][index].kind == UI_SizeKind_Null &&
+           layout->semanticSize[otherAx][index].kind == UI_SizeKind_PercentOfParent;
+}
+
+inline_function b32
+UI_Layout_TextSized(UI_LayoutTree* layout, u32 index)
+{
+    return layout->semanticSize[Axis2_X][index].kind == UI_SizeKind_TextContent ||
+           layout->semanticSize[Axis2_Y][index].kind == UI_SizeKind_TextContent;
+}
+
+// Flattens the widget tree declared this frame. This is the only pass that follows widget
+// pointers.
+root_function void
+UI_LayoutTree_Build(Arena* arena, UI_State* ui_state)
+{
+    UI_LayoutTree* layout = &ui_state->layout;
+    u64 capacity = Max(ui_state->frameWidgetCount, 1);
+    *layout = {};
+    layout->widget = PushArray(arena, UI_Widget*, capacity);
+    layout->parent = PushArray(arena, u32, capacity);
+    layout->subtreeSize = PushArray(arena, u32, capacity);
+    layout->childLayoutAxis = PushArray(arena, Axis2, capacity);
+    layout->subtreeHash = PushArray(arena, u64, capacity);
+    layout->inputClean = PushArray(arena, u8, capacity);
+    layout->cache = PushArray(arena, UI_LayoutCache, capacity);
+    for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+    {
+        layout->semanticSize[axis] = PushArray(arena, UI_Size, capacity);
+        layout->offeredSize[axis] = PushArray(arena, f32, capacity);
+        layout->computedSize[axis] = PushArray(arena, f32, capacity);
+        layout->relativePosition[axis] = PushArray(arena, f32, capacity);
+        layout->childOffset[axis] = PushArray(arena, f32, capacity);
+    }
+    layout->rect = PushArray(arena, F32Vec4, capacity);
+    layout->islandRoot = PushArray(arena, u8, capacity);
+    layout->island = PushArray(arena, u32, capacity / UI_State::LAYOUT_ISLAND_MIN + 1);
+
+    u32 index = 0;
+    for (UI_Widget* widget = ui_state->root; !UI_Widget_IsEmpty(widget);
+         widget = UI_Widget_DepthFirstPreOrder(widget))
+    {
+        ASSERT(index < capacity, "Layout tree holds more widgets than were declared");
+        widget->layoutIndex = index;
+        u32 parent = UI_LAYOUT_INDEX_NONE;
+        if (widget != ui_state->root && !UI_Widget_IsEmpty(widget->parent))
+        {
+            parent = widget->parent->layoutIndex;
+        }
+
+        layout->widget[index] = widget;
+        layout->parent[index] = parent;
+        layout->subtreeSize[index] = 1;
+        layout->childLayoutAxis[index] = widget->childLayoutAxis;
+        layout->islandRoot[index] = 0;
+        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        {
+            layout->semanticSize[axis][index] = widget->semanticSize[axis];
+            layout->childOffset[axis][index] = widget->childOffset[axis];
+        }
+        u64 inputHash = UI_Widget_LayoutInputHash(widget);
+        layout->inputClean[index] = inputHash == widget->layoutCache.inputHash;
+        layout->subtreeHash[index] = inputHash;
+        widget->layoutCache.inputHash = inputHash;
+        index++;
+    }
+    layout->count = index;
+
+    // children before parents: fold the child hashes in order, then grow the parent's subtree
+    for (u32 node = layout->count; node-- > 0;)
+    {
+        u64 hash = layout->subtreeHash[node];
+        u32 childEnd = node + layout->subtreeSize[node];
+        for (u32 child = node + 1; child < childEnd; child += layout->subtreeSize[child])
+        {
+            hash = HashFromU64(hash ^ layout->subtreeHash[child]);
+        }
+        layout->subtreeHash[node] = hash;
+        if (layout->parent[node] != UI_LAYOUT_INDEX_NONE)
+        {
+            layout->subtreeSize[layout->parent[node]] += layout->subtreeSize[node];
+        }
+    }
+
+    for (u32 node = 0; node < layout->count; node++)
+    {
+        UI_WidgetLayoutCache* cache = &layout->widget[node]->layoutCache;
+        b32 clean = layout->subtreeHash[node] == cache->subtreeHash;
+        layout->cache[node] = clean ? UI_LayoutCache_Clean : UI_LayoutCache_Dirty;
+        cache->subtreeHash = layout->subtreeHash[node];
+    }
+
+    // outermost islands only. One holding more than half the tree would leave the other threads
+    // idle, the islands inside it are taken instead.
+    for (u32 node = 0; node < layout->count;)
+    {
+        u32 subtreeSize = layout->subtreeSize[node];
+        if (layout->semanticSize[Axis2_X][node].kind == UI_SizeKind_Pixels &&
+            layout->semanticSize[Axis2_Y][node].kind == UI_SizeKind_Pixels &&
+            subtreeSize >= UI_State::LAYOUT_ISLAND_MIN && subtreeSize <= layout->count / 2)
+        {
+            layout->islandRoot[node] = 1;
+            layout->island[layout->islandCount++] = node;
+            node += subtreeSize;
+            continue;
+        }
+        node++;
+    }
+}
+
+// Pixels and TextContent. Text is only measured again when the widget's own inputs changed.
+// Text sized widgets start every axis at the text extent, other kinds build on top of it.
+root_function void
+UI_Layout_StandaloneSolve(UI_LayoutTree* layout, u32 begin, u32 end)
+{
+    for (u32 index = begin; index < end; index++)
+    {
+        Vec2<f32> size = {0.0f, 0.0f};
+        if (UI_Layout_TextSized(layout, index))
+        {
+            UI_Widget* widget = layout->widget[index];
+            if (!layout->inputClean[index])
+            {
+                widget->layoutCache.textExtent = widget->text_ext->size_calc_func(widget);
+            }
+            size = widget->layoutCache.textExtent;
+        }
+        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        {
+            UI_Size semanticSizeInfo = layout->semanticSize[axis][index];
+            if (semanticSizeInfo.kind == UI_SizeKind_Pixels)
+            {
+                size[axis] = semanticSizeInfo.value;
+            }
+            layout->computedSize[axis][index] = size[axis];
+        }
+    }
+}
+
+// PercentOfParent and filling Null axes take a share of the size offered by the parent. A node
+// sized by its children does not know its size yet and passes on what it was offered. This pass
+// also decides which clean subtrees are frozen.
+root_function void
+UI_Layout_UpwardSolve(UI_LayoutTree* layout, u32 begin, u32 end, F32Vec4 posAbs)
+{
+    for (u32 index = begin; index < end; index++)
+    {
+        u32 parent = layout->parent[index];
+        if (parent != UI_LAYOUT_INDEX_NONE && (layout->cache[parent] == UI_LayoutCache_Frozen ||
+                                               layout->cache[parent] == UI_LayoutCache_FrozenInner))
+        {
+            layout->cache[index] = UI_LayoutCache_FrozenInner;
+            continue;
+        }
+
+        Vec2<f32> available;
+        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        {
+            available[axis] = posAbs.point.p1[axis] - posAbs.point.p0[axis];
+            if (parent != UI_LAYOUT_INDEX_NONE)
+            {
+                available[axis] = layout->offeredSize[axis][parent];
+            }
+
+            f32* computedSize = layout->computedSize[axis];
+            UI_Size semanticSizeInfo = layout->semanticSize[axis][index];
+            b32 sized = 1;
+            if (semanticSizeInfo.kind == UI_SizeKind_PercentOfParent)
+            {
+                ASSERT(0.0f <= semanticSizeInfo.value && semanticSizeInfo.value <= 1.0f,
+                       "Semantic value must be a value between 0 and 1");
+                computedSize[index] = available[axis] * semanticSizeInfo.value;
+            }
+            else if (UI_Layout_FillsParent(layout, index, axis))
+            {
+                computedSize[index] = available[axis];
+            }
+            else if (semanticSizeInfo.kind == UI_SizeKind_ChildrenSum ||
+                     semanticSizeInfo.kind == UI_SizeKind_Null)
+            {
+                sized = 0;
+            }
+            layout->offeredSize[axis][index] = sized ? computedSize[index] : available[axis];
+        }
+
+        UI_WidgetLayoutCache* cache = &layout->widget[index]->layoutCache;
+        if (layout->cache[index] == UI_LayoutCache_Clean && available.x == cache->available.x &&
+            available.y == cache->available.y)
+        {
+            layout->cache[index] = UI_LayoutCache_Frozen;
+        }
+        cache->available = available;
+    }
+}
+
+// ChildrenSum adds up the children along the child layout axis and takes the largest child
+// across it. Null takes the largest child on both axes.
+root_function void
+UI_Layout_DownwardSolve(UI_LayoutTree* layout, u32 begin, u32 end)
+{
+    for (u32 index = end; index-- > begin;)
+    {
+        UI_LayoutCache cache = layout->cache[index];
+        if (cache == UI_LayoutCache_FrozenInner)
+        {
+            continue;
+        }
+        UI_Widget* widget = layout->widget[index];
+        if (cache == UI_LayoutCache_Frozen)
+        {
+            for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+            {
+                layout->computedSize[axis][index] = widget->layoutCache.contentSize[axis];
+            }
+            continue;
+        }
+
+        u32 childEnd = index + layout->subtreeSize[index];
+        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        {
+            f32* computedSize = layout->computedSize[axis];
+            UI_SizeKind kind = layout->semanticSize[axis][index].kind;
+            if (UI_Layout_FillsParent(layout, index, axis))
+            {
+                kind = UI_SizeKind_PercentOfParent;
+            }
+            b32 sum = kind == UI_SizeKind_ChildrenSum && layout->childLayoutAxis[index] == axis;
+            b32 max = kind == UI_SizeKind_Null ||
+                      (kind == UI_SizeKind_ChildrenSum && layout->childLayoutAxis[index] != axis);
+            f32 childrenSize = 0.0f;
+            if (sum || max)
+            {
+                for (u32 child = index + 1; child < childEnd; child += layout->subtreeSize[child])
+                {
+                    childrenSize = sum ? childrenSize + computedSize[child]
+                                       : Max(childrenSize, computedSize[child]);
+                }
+            }
+            if (sum)
+            {
+                computedSize[index] += childrenSize;
+            }
+            else if (max)
+            {
+                computedSize[index] = Max(computedSize[index], childrenSize);
+            }
+            widget->layoutCache.contentSize[axis] = computedSize[index];
+        }
+    }
+}
+
+// Runs the passes a frozen subtree skipped, for its inner nodes only. The root keeps the final
+// size its parent gave it.
+root_function void
+UI_Layout_SubtreeThaw(UI_LayoutTree* layout, u32 index, F32Vec4 posAbs)
+{
+    u32 childEnd = index + layout->subtreeSize[index];
+    for (u32 child = index + 1; child < childEnd; child++)
+    {
+        layout->cache[child] = UI_LayoutCache_Clean;
+    }
+    layout->cache[index] = UI_LayoutCache_Dirty;
+    UI_Layout_UpwardSolve(layout, index + 1, childEnd, posAbs);
+    UI_Layout_DownwardSolve(layout, index + 1, childEnd);
+}
+
+// Children that overflow their parent shrink towards their strictness, which is the smallest
+// size they accept. Along the child layout axis the overflow is shared in proportion to each
+// child's slack, across it every child is fitted on its own. Both are O(children), and since a
+// node is only visited after its parent fixed its size, the pass is O(n). Space that the
+// strictness of the children does not allow to take back stays as overflow. Islands are skipped
+// unless the range starts at one.
+root_function void
+UI_Layout_ViolationSolve(UI_LayoutTree* layout, u32 begin, u32 end, F32Vec4 posAbs)
+{
+    for (u32 index = begin; index < end;)
+    {
+        u32 childEnd = index + layout->subtreeSize[index];
+        if (index != begin && layout->islandRoot[index])
+        {
+            index = childEnd;
+            continue;
+        }
+        UI_Widget* widget = layout->widget[index];
+        Vec2<f32> size = {layout->computedSize[Axis2_X][index],
+                          layout->computedSize[Axis2_Y][index]};
+        if (layout->cache[index] == UI_LayoutCache_Frozen)
+        {
+            if (size.x == widget->layoutCache.size.x && size.y == widget->layoutCache.size.y)
+            {
+                layout->cache[index] = UI_LayoutCache_Reused;
+                index = childEnd;
+                continue;
+            }
+            UI_Layout_SubtreeThaw(layout, index, posAbs);
+        }
+        widget->layoutCache.size = size;
+
+        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        {
+            f32* computedSize = layout->computedSize[axis];
+            UI_Size* semanticSize = layout->semanticSize[axis];
+            if (layout->childLayoutAxis[index] == axis)
+            {
+                f32 childrenSize = 0.0f;
+                f32 slackTotal = 0.0f;
+                for (u32 child = index + 1; child < childEnd; child += layout->subtreeSize[child])
+                {
+                    childrenSize += computedSize[child];
+                    slackTotal += Max(computedSize[child] - semanticSize[child].strictness, 0.0f);
+                }
+                f32 violation = childrenSize - computedSize[index];
+                if (violation > 0.0f && slackTotal > 0.0f)
+                {
+                    f32 shrink = Min(violation / slackTotal, 1.0f);
+                    for (u32 child = index + 1; child < childEnd;
+                         child += layout->subtreeSize[child])
+                    {
+                        f32 slack = Max(computedSize[child] - semanticSize[child].strictness, 0.0f);
+                        computedSize[child] -= slack * shrink;
+                    }
+                }
+            }
+            else
+            {
+                for (u32 child = index + 1; child < childEnd; child += layout->subtreeSize[child])
+                {
+                    f32 violation = computedSize[child] - computedSize[index];
+                    if (violation > 0.0f)
+                    {
+                        f32 slack = Max(computedSize[child] - semanticSize[child].strictness, 0.0f);
+                        computedSize[child] -= Min(violation, slack);
+                    }
+                }
+            }
+        }
+        index++;
+    }
+}
+
+// Children follow each other along the child layout axis, starting at the parent's child
+// offset. Reused subtrees move their cached rects along with their root. Islands are skipped
+// unless the range starts at one. Returns the number of nodes whose rects were reused.
+root_function u32
+UI_Layout_PositionSolve(UI_LayoutTree* layout, u32 begin, u32 end, F32Vec4 posAbs)
+{
+    u32 reusedCount = 0;
+    for (u32 index = begin; index < end;)
+    {
+        u32 parent = layout->parent[index];
+        u32 childEnd = index + layout->subtreeSize[index];
+        if (index != begin && layout->islandRoot[index])
+        {
+            index = childEnd;
+            continue;
+        }
+        Vec2<f32> origin = posAbs.point.p0;
+        if (parent != UI_LAYOUT_INDEX_NONE)
+        {
+            origin = layout->rect[parent].point.p0;
+        }
+
+        F32Vec4 rect = {0};
+        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        {
+            f32 position = 0.0f;
+            if (parent != UI_LAYOUT_INDEX_NONE)
+            {
+                position = layout->relativePosition[axis][index];
+            }
+            rect.point.p0[axis] = origin[axis] + position;
+            rect.point.p1[axis] = rect.point.p0[axis] + layout->computedSize[axis][index];
+        }
+        layout->rect[index] = rect;
+
+        // the widget keeps the rect for the extensions, the next frame's hit test and the cache
+        UI_Widget* widget = layout->widget[index];
+        Vec2<f32> offset = rect.point.p0 - widget->rect.point.p0;
+        widget->rect = rect;
+        if (layout->cache[index] == UI_LayoutCache_Reused)
+        {
+            for (u32 child = index + 1; child < childEnd; child++)
+            {
+                UI_Widget* childWidget = layout->widget[child];
+                childWidget->rect.point.p0 = childWidget->rect.point.p0 + offset;
+                childWidget->rect.point.p1 = childWidget->rect.point.p1 + offset;
+                layout->rect[child] = childWidget->rect;
+            }
+            reusedCount += layout->subtreeSize[index];
+            index = childEnd;
+            continue;
+        }
+
+        u32 layoutAxis = layout->childLayoutAxis[index];
+        u32 crossAxis = (layoutAxis + 1) % Axis2_COUNT;
+        f32 cursor = layout->childOffset[layoutAxis][index];
+        for (u32 child = index + 1; child < childEnd; child += layout->subtreeSize[child])
+        {
+            layout->relativePosition[layoutAxis][child] = cursor;
+            layout->relativePosition[crossAxis][child] = layout->childOffset[crossAxis][index];
+            cursor += layout->computedSize[layoutAxis][child];
+        }
+        index++;
+    }
+    return reusedCount;
+}
+
+struct UI_LayoutIslandWork
+{
+    UI_LayoutTree* layout;
+    F32Vec4 posAbs;
+    u32* reusedCount; // one per island
+};
+
+// The inner nodes of an island, for the passes that run before its root's final size is known.
+root_function void
+UI_Layout_IslandSizeWork(void* data, u64 island_i)
+{
+    UI_LayoutIslandWork* work = (UI_LayoutIslandWork*)data;
+    UI_LayoutTree* layout = work->layout;
+    u32 island = layout->island[island_i];
+    u32 islandEnd = island + layout->subtreeSize[island];
+    UI_Layout_UpwardSolve(layout, island + 1, islandEnd, work->posAbs);
+    UI_Layout_DownwardSolve(layout, island + 1, islandEnd);
+}
+
+// An island inside a reused subtree was already moved along with it.
+root_function void
+UI_Layout_IslandPlaceWork(void* data, u64 island_i)
+{
+    UI_LayoutIslandWork* work = (UI_LayoutIslandWork*)data;
+    UI_LayoutTree* layout = work->layout;
+    u32 island = layout->island[island_i];
+    u32 islandEnd = island + layout->subtreeSize[island];
+    work->reusedCount[island_i] = 0;
+    if (layout->cache[island] != UI_LayoutCache_FrozenInner)
+    {
+        UI_Layout_ViolationSolve(layout, island, islandEnd, work->posAbs);
+        work->reusedCount[island_i] =
+            UI_Layout_PositionSolve(layout, island, islandEnd, work->posAbs);
+    }
+}
+
+// Text is measured on the calling thread, the font state is not shared. The rest of the tree
+// is solved around the islands, which go to the work pool once for the passes before their root
+// is sized by its parent and once for the passes after.
+root_function void
+UI_Layout_Solve(UI_State* ui_state, WorkPool* pool, F32Vec4 posAbs)
+{
+    UI_LayoutTree* layout = &ui_state->layout;
+    UI_LayoutIslandWork work = {layout, posAbs, 0};
+    work.reusedCount = PushArray(ui_state->arena_frame, u32, Max(layout->islandCount, 1));
+
+    UI_Layout_StandaloneSolve(layout, 0, layout->count);
+
+    // the island roots are part of the surrounding tree, their inner nodes are not
+    u32 begin = 0;
+    for (u32 island_i = 0; island_i < layout->islandCount; island_i++)
+    {
+        u32 island = layout->island[island_i];
+        UI_Layout_UpwardSolve(layout, begin, island + 1, posAbs);
+        begin = island + layout->subtreeSize[island];
+    }
+    UI_Layout_UpwardSolve(layout, begin, layout->count, posAbs);
+    WorkPoolRun(pool, UI_Layout_IslandSizeWork, &work, layout->islandCount);
+
+    u32 end = layout->count;
+    for (u32 island_i = layout->islandCount; island_i-- > 0;)
+    {
+        u32 island = layout->island[island_i];
+        UI_Layout_DownwardSolve(layout, island + layout->subtreeSize[island], end);
+        end = island + 1;
+    }
+    UI_Layout_DownwardSolve(layout, 0, end);
+
+    UI_Layout_ViolationSolve(layout, 0, layout->count, posAbs);
+    layout->reusedCount = UI_Layout_PositionSolve(layout, 0, layout->count, posAbs);
+    WorkPoolRun(pool, UI_Layout_IslandPlaceWork, &work, layout->islandCount);
+    for (u32 island_i = 0; island_i < layout->islandCount; island_i++)
+    {
+        layout->reusedCount += work.reusedCount[island_i];
+    }
+    TracyPlot("layout nodes reused", (int64_t)layout->reusedCount);
+    TracyPlot("layout islands", (int64_t)layout->islandCount);
+}
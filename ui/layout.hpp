@@ -0,0 +1,23 @@
+#pragma once
+
+root_function void
+UI_LayoutTree_Build(Arena* arena, UI_State* ui_state);
+
+// solver passes over the node range [begin, end)
+root_function void
+UI_Layout_StandaloneSolve(UI_LayoutTree* layout, u32 begin, u32 end);
+
+root_function void
+UI_Layout_UpwardSolve(UI_LayoutTree* layout, u32 begin, u32 end, F32Vec4 posAbs);
+
+root_function void
+UI_Layout_DownwardSolve(UI_LayoutTree* layout, u32 begin, u32 end);
+
+root_function void
+UI_Layout_ViolationSolve(UI_LayoutTree* layout, u32 begin, u32 end, F32Vec4 posAbs);
+
+root_function u32
+UI_Layout_PositionSolve(UI_LayoutTree* layout, u32 begin, u32 end, F32Vec4 posAbs);
+
+root_function void
+UI_Layout_Solve(UI_State* ui_state, WorkPool* pool, F32Vec4 posAbs);
@@ -0,0 +1,74 @@
+// The hot widget and its parents are last frame's tree, none of them has been pruned yet.
+root_function b32
+UI_Widget_IsHotWithin(UI_State* ui_state, UI_Widget* widget)
+{
+    UI_Widget** hot = HashMapFind(&ui_state->widgetMap, ui_state->hotKey.key);
+    if (IsNull(hot))
+    {
+        return 0;
+    }
+    for (UI_Widget* node = *hot; !UI_Widget_IsEmpty(node); node = node->parent)
+    {
+        if (node == widget)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// A scrolling list of rowCount rows of rowHeight pixels. Only the rows that overlap the list's
+// rect from last frame, plus LIST_OVERSCAN_ROWS on either side, are declared, so the cost of a
+// frame does not depend on rowCount. Rows are keyed by their index and laid out from the list's
+// child offset, which moves the first declared row to where it sits in the scrolled content.
+// The scroll position is kept in f64, f32 runs out of precision a few million pixels down.
+root_function void
+UI_List_Add(UI_Key localKey, UI_WidgetFlags flags, UI_Size semanticSizeX,
+            UI_Size semanticSizeY, u64 rowCount, f32 rowHeight, UI_ListRowBuildFunc* rowBuild,
+            void* data)
+{
+    Context* context = GlobalContextGet();
+    UI_State* ui_state = context->ui_state;
+    UI_IO* io = context->io;
+    ASSERT(rowHeight > 0.0f, "List rows need a height");
+
+    flags |= UI_WidgetFlag_ViewScroll | UI_WidgetFlag_Clip;
+    C_ChildLayoutAxis_SetNext(Axis2_Y);
+    UI_Widget_Add(localKey, flags, semanticSizeX, semanticSizeY);
+    UI_Widget* list = ui_state->current;
+
+    // the first frame has no rect yet
+    f64 viewSize = list->rect.point.p1.y - list->rect.point.p0.y;
+    if (viewSize <= 0.0 && semanticSizeY.kind == UI_SizeKind_Pixels)
+    {
+        viewSize = semanticSizeY.value;
+    }
+    f64 contentSize = (f64)rowCount * rowHeight;
+    f64 viewOffset = list->viewOffset.y;
+    if (UI_Widget_IsHotWithin(ui_state, list))
+    {
+        viewOffset -= io->scrollDelta.y * rowHeight * (f64)UI_State::LIST_SCROLL_ROWS;
+    }
+    viewOffset = Clamp(viewOffset, 0.0, Max(contentSize - viewSize, 0.0));
+    list->viewOffset.y = viewOffset;
+
+    u64 rowFirst = (u64)(viewOffset / rowHeight);
+    u64 rowEnd = (u64)((viewOffset + viewSize) / rowHeight) + 1;
+    rowFirst -= Min(rowFirst, UI_State::LIST_OVERSCAN_ROWS);
+    rowEnd = Min(rowEnd + UI_State::LIST_OVERSCAN_ROWS, rowCount);
+    list->childOffset.y = (f32)((f64)rowFirst * rowHeight - viewOffset);
+
+    UI_Size rowSizeX = {.kind = UI_SizeKind_PercentOfParent, .value = 1.0f, .strictness = 0.0f};
+    UI_Size rowSizeY = {.kind = UI_SizeKind_Pixels, .value = rowHeight, .strictness = rowHeight};
+    UI_Layout_Scoped
+    {
+        for (u64 row_i = rowFirst; row_i < rowEnd; row_i++)
+        {
+            UI_Widget_Add(row_i, 0, rowSizeX, rowSizeY);
+            UI_Layout_Scoped
+            {
+                rowBuild(data, row_i);
+            }
+        }
+    }
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+// Declares the contents of one row. The row itself is already declared and is the parent.
+typedef void UI_ListRowBuildFunc(void* data, u64 row_i);
+
+root_function void
+UI_List_Add(UI_Key localKey, UI_WidgetFlags flags, UI_Size semanticSizeX,
+            UI_Size semanticSizeY, u64 rowCount, f32 rowHeight, UI_ListRowBuildFunc* rowBuild,
+            void* data);
+
+root_function b32
+UI_Widget_IsHotWithin(UI_State* ui_state, UI_Widget* widget);
@@ -24,7 +24,8 @@ static const F32Vec4 C_Margin_Default = {5.f, 5.f, 5.f, 5.f};
     X(C_Text,               String8,        {0}) \
     X(C_BackgroundColor,    F32Vec4,        {0}) \
     X(C_Padding,            F32Vec4,        C_Padding_Default) \
-    X(C_Margin,             F32Vec4,        C_Margin_Default)
+    X(C_Margin,             F32Vec4,        C_Margin_Default) \
+    X(C_ChildLayoutAxis,    Axis2,          Axis2_X)
 
 enum WidgetConfigEnum {
     #define X(name, type, default) name,
@@ -32,14 +33,28 @@ enum WidgetConfigEnum {
     #undef X
     WIDGET_CONFIG_COUNT
 };
-struct Config {
-    WidgetConfigEnum type_enum;
-    Config* next;
-    void* ptr;
+
+// Each option is a fixed size stack stored inline, so pushing and popping never allocates.
+// autoPop marks a top pushed with _SetNext, which the next UI_Widget_Add pops again. Pushing past
+// the capacity exits in every build, since dropping a C_Parent push would silently attach the
+// following widgets to the wrong parent.
+static const u32 UI_CONFIG_STACK_CAPACITY = 64;
+
+struct UI_Widget;
+
+template <typename T> struct UI_ConfigStack
+{
+    T items[UI_CONFIG_STACK_CAPACITY];
+    u32 count;
+    b32 autoPop;
 };
 
-struct ConfigBucket {
-    Config* c[WIDGET_CONFIG_COUNT];
+struct UI_ConfigStacks
+{
+#define X(name, type, default) UI_ConfigStack<type> name;
+    WidgetCfg
+#undef X
+    b32 autoPopPending; // any stack has autoPop set
 };
 
 // UI State --------------------------------------------
@@ -90,17 +105,39 @@ struct UI_Key
 };
 
 
+// Styles are interned by content into UI_StyleTable and widgets reference theirs by id, so
+// widgets that look the same share one record. The fields are laid out without padding, the
+// bytes of the record are its key.
+typedef u32 UI_StyleId;
+struct UI_Style
+{
+    F32Vec4 background_color;
+    F32Vec4 padding;
+    F32Vec4 margin;
+    f32 softness;
+    f32 border_thickness;
+    f32 corner_radius;
+    u32 font_size;
+};
+
+// Ids stay valid until UI_State_FrameReset empties a table that has grown past
+// STYLE_TABLE_RESET_COUNT, e.g. from colors animated over many frames.
+struct UI_StyleTable
+{
+    Arena* arena;
+    HashMap<u128, UI_StyleId> map; // content hash to id
+    UI_Style* styles;              // indexed by id
+    u32 count;
+    u32 capacity;
+};
+
 //format + styling extension
 struct UI_Widget;
 typedef Vec2<f32> UI_TextExtSizeCalcFuncType(UI_Widget* widget);
 typedef void UI_TextExtDrawFuncType(UI_Widget* widget);
 struct UI_TextExtData {
-    u32 font_size;
     String8 text;
     Vec2<f32> text_size;
-    f32 border_thickness;
-    F32Vec4 padding;
-    F32Vec4 margin;
 };
 struct UI_TextExt {
     UI_TextExtSizeCalcFuncType* size_calc_func;
@@ -109,22 +146,28 @@ struct UI_TextExt {
 };
 
 typedef void UI_RectExtDrawFuncType(UI_Widget* widget);
-struct UI_RectExtData {
-    F32Vec4 background_color;
-    f32 softness; 
-    f32 border_thickness; 
-    f32 corner_radius;
-    F32Vec4 margin;
-};
 struct UI_RectExt {
-    UI_RectExtData* data;
     UI_RectExtDrawFuncType* draw_func;
 };
 
+// Layout results of the last frame the widget was laid out in, reused while its inputs match.
+struct UI_WidgetLayoutCache
+{
+    u64 subtreeHash;
+    u64 inputHash;
+    Vec2<f32> textSize;    // measured text, seeds the text extension of the next frame
+    Vec2<f32> textExtent;  // text plus border, padding and margin
+    Vec2<f32> available;   // size offered by the nearest sized ancestor
+    Vec2<f32> contentSize; // size after the children were summed
+    Vec2<f32> size;        // final size
+};
+
 struct UI_Widget
 {
-    UI_Widget* hashNext;
-    UI_Widget* hashPrev;
+    // touch order, least recently declared first
+    UI_Widget* lruNext;
+    UI_Widget* lruPrev;
+    u64 lastFrameTouched;
 
     UI_Widget* first;
     UI_Widget* next;
@@ -135,6 +178,7 @@ struct UI_Widget
     // format + styling extensions
     UI_TextExt* text_ext;
     UI_RectExt* rect_ext;
+    UI_StyleId style; // set when the widget draws a background or text
 
     String8 name;
     
@@ -143,19 +187,94 @@ struct UI_Widget
     UI_Key key;
 
     UI_Size semanticSize[Axis2_COUNT];
-    Vec2<f32> computedRelativePosition;
-    Vec2<f32> computedSize;
     F32Vec4 rect;
+    u32 layoutIndex; // position in this frame's UI_LayoutTree
+
+    Axis2 childLayoutAxis; // children are placed one after another along this axis
+    UI_WidgetLayoutCache layoutCache;
+
+    // scrolling, see UI_List_Add
+    Vec2<f64> viewOffset;  // scroll position in content space, kept across frames
+    Vec2<f32> childOffset; // where the first child is placed, set every frame
 
     bool hot_t;
     bool active_t;
 
 };
 
-struct UI_WidgetSlot
+// The widget tree of one frame flattened in pre-order, one array per field. The subtree of node i
+// is the index range [i, i + subtreeSize[i]), so children are reached by skipping subtrees and a
+// reverse scan visits every child before its parent.
+//
+// Sizes are solved in passes that are each a linear scan over these columns:
+//   standalone  Pixels and TextContent, from the node alone
+//   upward      PercentOfParent, from the size offered by the nearest sized ancestor
+//   downward    ChildrenSum and Null, from the children, in reverse order
+//   violations  children that overflow their parent give up space in proportion to their slack,
+//               the part of their size above strictness, in pre-order
+//   position    children are placed along the parent's childLayoutAxis, in pre-order
+//
+// Layout is incremental. subtreeHash covers the layout inputs of a whole subtree. A subtree whose
+// hash matches the previous frame and that is offered the same size is frozen: its inner nodes
+// skip the upward and downward passes and its root takes the cached content size. If the parent
+// then also gives it the same final size, the subtree's rects are the cached ones moved along
+// with the root. Otherwise the skipped passes are run for that subtree only.
+//
+// A node with a Pixels size on both axes does not depend on its children, and its children only
+// depend on it. Large subtrees under such nodes are islands: the passes skip their inner nodes
+// and every island is then solved on its own, on the work pool. Each island runs the same passes
+// in the same order as a single scan would, so the result does not depend on the thread count.
+const u32 UI_LAYOUT_INDEX_NONE = 0xffffffff;
+
+typedef u8 UI_LayoutCache;
+enum
 {
-    UI_Widget* first;
-    UI_Widget* last;
+    UI_LayoutCache_Dirty,
+    UI_LayoutCache_Clean,       // same inputs as last frame
+    UI_LayoutCache_Frozen,      // clean and offered the same size, sized from the cache
+    UI_LayoutCache_FrozenInner, // inside a frozen subtree, not sized
+    UI_LayoutCache_Reused,      // frozen and given the same final size, rects are reused
+};
+
+struct UI_LayoutTree
+{
+    u32 count;
+    UI_Widget** widget;
+    u32* parent;
+    u32* subtreeSize;
+    Axis2* childLayoutAxis;
+    u64* subtreeHash;
+    u8* inputClean;
+    UI_LayoutCache* cache;
+    UI_Size* semanticSize[Axis2_COUNT];
+    f32* offeredSize[Axis2_COUNT]; // what the node offers its PercentOfParent descendants
+    f32* computedSize[Axis2_COUNT];
+    f32* relativePosition[Axis2_COUNT];
+    f32* childOffset[Axis2_COUNT];
+    F32Vec4* rect;
+    F32Vec4* visible; // rect clipped by Clip ancestors, from UI_Widget_DrawPrepare, empty if culled
+    u8* islandRoot;
+    u32* island; // island roots in pre-order
+    u32 islandCount;
+    u32 reusedCount;
+};
+
+// Rects of last frame's hit targets bucketed into a uniform grid. Each cell lists the targets
+// overlapping it in draw order, so the topmost one under a point is the last that contains it.
+struct UI_HitEntry
+{
+    F32Vec4 rect;
+    UI_Key key;
+};
+
+struct UI_HitGrid
+{
+    Vec2<f32> origin;
+    f32 cellSize;
+    u32 cellCountX;
+    u32 cellCountY;
+    u32* cellStart; // entries of cell c are [cellStart[c], cellStart[c + 1])
+    UI_HitEntry* entries;
 };
 
 struct UI_State
@@ -163,32 +282,63 @@ struct UI_State
     Arena* arena_permanent;
 
     // frame state
+    // one arena per frame in flight, so data referenced by a submitted frame stays valid until
+    // its fence signals. arena_frame points at the one of the frame being recorded.
+    Arena* arena_frames[VulkanContext::MAX_FRAMES_IN_FLIGHT];
     Arena* arena_frame;
     UI_Widget* current; // current widget
     UI_Widget* root;    // root of tree structure
-
-    // ui cache size
-    u64 widgetCacheSize;
-    UI_WidgetSlot* widgetSlot;
-    UI_Widget* freeList;
-    u64 freeListSize;
+    u32 frameWidgetCount;
+    UI_LayoutTree layout;
+
+    // subtrees with at least this many nodes are laid out in parallel when they are independent
+    static const u32 LAYOUT_ISLAND_MIN = 256;
+
+    // widget cache, grows with the live widget count and rehashes a step per frame
+    static const u64 WIDGET_CACHE_CAPACITY = 1024;
+    static const u64 WIDGET_CACHE_REHASH_STEP = 1024;
+    HashMap<u64, UI_Widget*> widgetMap;
+    Pool<UI_Widget> widgetPool;
+
+    // widgets not declared for more than pruneGraceFrames frames are evicted at the end of the
+    // frame. The touch order list keeps the stale ones at the front, so pruning only visits them.
+    static const u64 WIDGET_PRUNE_GRACE_FRAMES = 2;
+    u64 frameCount;
+    u64 pruneGraceFrames;
+    UI_Widget* lruFirst;
+    UI_Widget* lruLast;
+
+    // hit testing, widgets that are clickable or draw a background are hit targets and cover
+    // the ones drawn before them
+    static constexpr f32 HIT_GRID_CELL_SIZE = 64.0f;
+    static const u32 HIT_GRID_CELLS_MAX = 64; // per axis, cells grow beyond this
+    UI_HitGrid hitGrid;
+    UI_Key hotKey;         // topmost hit target under the mouse
+    UI_Key activeKey;      // hit target the button was pressed on, until it is released
+    bool leftClickedPrev;
+
+    F32Vec4 clip; // clip rect of the widget being drawn, see UI_Widget_DrawPrepare
+
+    // interned widget styles, kept across frames
+    static const u32 STYLE_TABLE_CAPACITY = 256;
+    static const u32 STYLE_TABLE_RESET_COUNT = 16384;
+    UI_StyleTable styleTable;
+
+    // virtualized lists build the rows in view plus this many on either side
+    static const u64 LIST_OVERSCAN_ROWS = 2;
+    static const u64 LIST_SCROLL_ROWS = 3; // rows per scroll wheel step
 
     // Configuration options
-    ConfigBucket cfg_bucket;
+    UI_ConfigStacks cfg_stacks;
 };
 
 struct UI_IO
 {
     Vec2<f64> mousePosition;
+    Vec2<f64> scrollDelta; // scroll wheel steps since the last frame
     bool leftClicked;
 };
 
-// Threading Context
-struct ThreadCtx
-{
-    Arena* scratchArenas[2];
-};
-
 // global contexts 
 struct Context
 {
@@ -199,6 +349,7 @@ struct Context
     UI_IO* io;
     UI_State* ui_state;
     ThreadCtx* thread_ctx;
+    ArenaRegistry* arena_registry;
 
     u64 frameTickPrev;
     f64 frameRate;
@@ -206,6 +357,9 @@ struct Context
 
     // empty objects
     UI_Widget* g_ui_widget;
+
+    // started by the entrypoint library, which holds the code the workers run
+    WorkPool work_pool;
 };
 
 
@@ -0,0 +1,68 @@
+root_function UI_StyleTable
+UI_StyleTable_Alloc(Arena* arena, u32 capacity)
+{
+    UI_StyleTable table = {};
+    table.arena = arena;
+    table.map = HashMapAlloc<u128, UI_StyleId>(arena, capacity);
+    table.styles = PushArray(arena, UI_Style, capacity);
+    table.capacity = capacity;
+    return table;
+}
+
+// Ids are handed out for the whole frame, so the table is only ever emptied between frames. The
+// storage is kept, the next frame interns its styles again from id 0.
+root_function void
+UI_StyleTable_FrameReset(UI_StyleTable* table, u32 resetCount)
+{
+    TracyPlot("style table count", (int64_t)table->count);
+    if (table->count >= resetCount)
+    {
+        HashMapClear(&table->map);
+        table->count = 0;
+    }
+}
+
+root_function UI_StyleId
+UI_Style_Intern(UI_StyleTable* table, UI_Style* style)
+{
+    u128 hash = HashFromStr8(String8{sizeof(UI_Style), (u8*)style});
+    b32 inserted;
+    UI_StyleId* id = HashMapFindOrInsert(&table->map, hash, &inserted);
+    if (inserted)
+    {
+        if (table->count == table->capacity)
+        {
+            // the old array stays in the arena, growth is rare once the styles of a screen exist
+            UI_Style* styles = PushArray(table->arena, UI_Style, table->capacity * 2);
+            MemoryCopy(styles, table->styles, sizeof(UI_Style) * table->count);
+            table->styles = styles;
+            table->capacity *= 2;
+        }
+        *id = table->count++;
+        table->styles[*id] = *style;
+    }
+    return *id;
+}
+
+inline_function UI_Style*
+UI_Style_FromId(UI_StyleTable* table, UI_StyleId id)
+{
+    ASSERT(id < table->count, "Style id from before the table was reset");
+    return &table->styles[id];
+}
+
+// Interns the style the config stacks describe for the widget being added.
+root_function UI_StyleId
+UI_Style_FromConfig(UI_StyleTable* table)
+{
+    UI_Style style = {
+        .background_color = C_BackgroundColor_Get(),
+        .padding = C_Padding_Get(),
+        .margin = C_Margin_Get(),
+        .softness = C_Softness_Get(),
+        .border_thickness = C_BorderThickness_Get(),
+        .corner_radius = C_CornerRadius_Get(),
+        .font_size = C_FontSize_Get(),
+    };
+    return UI_Style_Intern(table, &style);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+root_function UI_StyleTable
+UI_StyleTable_Alloc(Arena* arena, u32 capacity);
+
+root_function void
+UI_StyleTable_FrameReset(UI_StyleTable* table, u32 resetCount);
+
+root_function UI_StyleId
+UI_Style_Intern(UI_StyleTable* table, UI_Style* style);
+
+inline_function UI_Style*
+UI_Style_FromId(UI_StyleTable* table, UI_StyleId id);
+
+root_function UI_StyleId
+UI_Style_FromConfig(UI_StyleTable* table);
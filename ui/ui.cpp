@@ -5,3 +5,7 @@
 #include "state.cpp"
 #include "fonts.cpp"
 #include "widget.cpp"
+#include "style.cpp"
+#include "layout.cpp"
+#include "hit_test.cpp"
+#include "list.cpp"
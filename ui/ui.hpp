@@ -18,4 +18,8 @@
 #include "fonts.hpp"
 #include "state.hpp"
 #include "globals.hpp"
-#include "widget.hpp"
\ No newline at end of file
+#include "widget.hpp"
+#include "style.hpp"
+#include "layout.hpp"
+#include "hit_test.hpp"
+#include "list.hpp"
\ No newline at end of file
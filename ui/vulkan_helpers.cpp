@@ -652,4 +652,41 @@ querySwapChainSupport(Arena* arena, VulkanContext* vulkanContext, VkPhysicalDevi
     }
 
     return details;
-}
\ No newline at end of file
+}
+
+root_function void
+ScissorBatchPush(ChunkList<ScissorBatch>* batches, F32Vec4 clip, u64 instanceOffset,
+                 u64 instanceCount)
+{
+    if (instanceCount == 0)
+    {
+        return;
+    }
+    if (!IsNull(batches->last) && batches->last->count > 0)
+    {
+        ScissorBatch* last = &batches->last->items[batches->last->count - 1];
+        if (last->instanceOffset + last->instanceCount == instanceOffset &&
+            last->clip.data[0] == clip.data[0] && last->clip.data[1] == clip.data[1] &&
+            last->clip.data[2] == clip.data[2] && last->clip.data[3] == clip.data[3])
+        {
+            last->instanceCount += instanceCount;
+            return;
+        }
+    }
+    *ChunkListPush(batches) = {clip, instanceOffset, instanceCount};
+}
+
+// Rounds outwards to whole pixels and clamps to the framebuffer, scissors must not go past it.
+root_function VkRect2D
+ScissorFromClip(F32Vec4 clip, VkExtent2D extent)
+{
+    f32 x0 = Clamp(floorf(clip.point.p0.x), 0.0f, (f32)extent.width);
+    f32 y0 = Clamp(floorf(clip.point.p0.y), 0.0f, (f32)extent.height);
+    f32 x1 = Clamp(ceilf(clip.point.p1.x), x0, (f32)extent.width);
+    f32 y1 = Clamp(ceilf(clip.point.p1.y), y0, (f32)extent.height);
+
+    VkRect2D scissor{};
+    scissor.offset = {(i32)x0, (i32)y0};
+    scissor.extent = {(u32)x1 - (u32)x0, (u32)y1 - (u32)y0};
+    return scissor;
+}
@@ -17,6 +17,15 @@ struct Vulkan_PushConstantInfo
     uint32_t size;
 };
 
+// A run of instances drawn under one scissor. Instances are pushed in draw order, so consecutive
+// instances with the same clip rect share a batch and a vkCmdSetScissor.
+struct ScissorBatch
+{
+    F32Vec4 clip;
+    u64 instanceOffset;
+    u64 instanceCount;
+};
+
 struct SwapChainSupportDetails
 {
     VkSurfaceCapabilitiesKHR capabilities;
@@ -52,7 +61,7 @@ struct VulkanContext
 
     const u32 WIDTH = 800;
     const u32 HEIGHT = 600;
-    const u32 MAX_FRAMES_IN_FLIGHT = 2;
+    static const u32 MAX_FRAMES_IN_FLIGHT = 2;
 
     const char* validationLayers[1] = {"VK_LAYER_KHRONOS_validation"};
 
@@ -176,3 +185,10 @@ QueueFamiliesFind(VulkanContext* vulkanContext, VkPhysicalDevice device);
 
 root_function SwapChainSupportDetails
 querySwapChainSupport(Arena* arena, VulkanContext* vulkanContext, VkPhysicalDevice device);
+
+root_function void
+ScissorBatchPush(ChunkList<ScissorBatch>* batches, F32Vec4 clip, u64 instanceOffset,
+                 u64 instanceCount);
+
+root_function VkRect2D
+ScissorFromClip(F32Vec4 clip, VkExtent2D extent);
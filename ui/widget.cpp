@@ -15,53 +15,60 @@ inline_function void UI_Widget_TreeStateReset(UI_Widget* widget) {
 root_function UI_Widget*
 UI_Widget_FromKey(UI_State* ui_state, UI_Key key)
 {
-    UI_Widget* result = {0};
-    u64 slotKey = key.key % ui_state->widgetCacheSize;
-    UI_WidgetSlot* slot = &ui_state->widgetSlot[slotKey];
-
-    for (UI_Widget* widget = slot->first; !UI_Widget_IsEmpty(widget); widget = widget->hashNext)
-    {
-        if (UI_Key_IsEqual(widget->key, key))
-        {
-            result = widget;
-            break;
-        }
-    }
-
-    if (UI_Widget_IsEmpty(result))
+    b32 inserted;
+    UI_Widget** slot = HashMapFindOrInsert(&ui_state->widgetMap, key.key, &inserted);
+    if (inserted)
     {
-        result = UI_WidgetSlot_Push(ui_state, key);
+        UI_Widget* widget = UI_Widget_Allocate(ui_state);
+        widget->key = key;
+        widget->lastFrameTouched = ui_state->frameCount;
+        DLLPushBack_NPZ(ui_state->lruFirst, ui_state->lruLast, widget, lruNext, lruPrev, IsNull,
+                        SetNull);
+        *slot = widget;
     }
-    return result;
+    return *slot;
 }
 
 root_function UI_Widget*
 UI_Widget_Allocate(UI_State* ui_state)
 {
-    UI_Widget* widget = ui_state->freeList;
-    if (ui_state->freeListSize > 0)
-    {
-        StackPop(ui_state->freeList);
-        MemoryZeroStruct(widget);
-        ui_state->freeListSize -= 1;
-    }
-    else
+    return PoolPushZero(&ui_state->widgetPool);
+}
+
+// Stamps the widget with the current frame and moves it to the back of the touch order.
+root_function void
+UI_Widget_Touch(UI_State* ui_state, UI_Widget* widget)
+{
+    if (widget->lastFrameTouched != ui_state->frameCount)
     {
-        widget = PushStruct(ui_state->arena_permanent, UI_Widget);
+        widget->lastFrameTouched = ui_state->frameCount;
+        DLLRemove_NPZ(ui_state->lruFirst, ui_state->lruLast, widget, lruNext, lruPrev, IsNull,
+                      SetNull);
+        DLLPushBack_NPZ(ui_state->lruFirst, ui_state->lruLast, widget, lruNext, lruPrev, IsNull,
+                        SetNull);
     }
-    return widget;
 }
 
-// UI_WidgetSlot
-root_function UI_Widget*
-UI_WidgetSlot_Push(UI_State* ui_state, UI_Key key)
+// Evicts widgets that were not declared in the last pruneGraceFrames frames and returns them to
+// the pool. Runs after layout, when nothing of this frame refers to a stale widget.
+root_function void
+UI_Widget_Prune(UI_State* ui_state)
 {
-    UI_WidgetSlot* slot = &ui_state->widgetSlot[key.key % ui_state->widgetCacheSize];
-    UI_Widget* widget = UI_Widget_Allocate(ui_state);
-
-    DLLPushBack_NPZ(slot->first, slot->last, widget, hashNext, hashPrev, UI_Widget_IsEmpty, SetNull);
-    widget->key = key;
-    return widget;
+    u64 pruneCount = 0;
+    while (!IsNull(ui_state->lruFirst))
+    {
+        UI_Widget* widget = ui_state->lruFirst;
+        if (ui_state->frameCount - widget->lastFrameTouched <= ui_state->pruneGraceFrames)
+        {
+            break;
+        }
+        DLLRemove_NPZ(ui_state->lruFirst, ui_state->lruLast, widget, lruNext, lruPrev, IsNull,
+                      SetNull);
+        HashMapRemove(&ui_state->widgetMap, widget->key.key);
+        PoolFree(&ui_state->widgetPool, widget);
+        pruneCount++;
+    }
+    TracyPlot("widgets pruned", (int64_t)pruneCount);
 }
 
 // UI_Key
@@ -73,6 +80,29 @@ UI_Key_Calculate(String8 str)
     return key;
 }
 
+// Keys below are seeded with the parent's key, so a name or id only has to be unique among its
+// siblings.
+root_function UI_Key
+UI_Key_Calculate(UI_Key seed, u64 id)
+{
+    UI_Key key = {HashFromU64(seed.key ^ HashFromU64(id + 1))};
+    // the null key marks an unused widget
+    key.key += UI_Key_IsNull(key);
+    return key;
+}
+
+root_function UI_Key
+UI_Key_Calculate(UI_Key seed, UI_Key local)
+{
+    return UI_Key_Calculate(seed, local.key);
+}
+
+root_function UI_Key
+UI_Key_Calculate(UI_Key seed, String8 str)
+{
+    return UI_Key_Calculate(seed, UI_Key_Calculate(str).key);
+}
+
 root_function bool
 UI_Key_IsEqual(UI_Key key0, UI_Key key1)
 {
@@ -107,201 +137,86 @@ UI_Widget_DepthFirstPreOrder(UI_Widget* widget)
     return next;
 }
 
-inline_function UI_Widget*
-UI_Widget_TreeLeftMostFind(UI_Widget* root)
-{
-    UI_Widget* child = root;
-    for (; !UI_Widget_IsEmpty(child) && !UI_Widget_IsEmpty(child->first); child = child->first)
-    {
-    };
-    return child;
-}
-
-root_function UI_Widget*
-UI_Widget_DepthFirstPostOrder(UI_Widget* widget)
+inline_function F32Vec4
+UI_RectIntersect(F32Vec4 rect0, F32Vec4 rect1)
 {
-    UI_Widget* next = {0};
-    if (UI_Widget_IsEmpty(widget->next))
+    F32Vec4 rect = {0};
+    for (u32 axis = 0; axis < Axis2_COUNT; axis++)
     {
-        next = widget->parent;
+        rect.point.p0[axis] = Max(rect0.point.p0[axis], rect1.point.p0[axis]);
+        rect.point.p1[axis] = Min(rect0.point.p1[axis], rect1.point.p1[axis]);
     }
-    else
-        for (next = widget->next; !UI_Widget_IsEmpty(next->first); next = next->first)
-        {
-        }
-    return next;
+    return rect;
 }
 
-typedef u32 IterState;
-enum
-{
-    UI_IterState_PRE,
-    UI_IterState_POST,
-    UI_IterState_Count
-};
-
-struct UI_WidgetDF
+inline_function b32
+UI_RectIsEmpty(F32Vec4 rect)
 {
-    UI_Widget* next;
-    IterState iterState;
-};
-
-
+    return rect.point.p0.x >= rect.point.p1.x || rect.point.p0.y >= rect.point.p1.y;
+}
 
+// Clip widgets restrict their descendants to their rect, intersected with the clip they are in
+// themselves. A stack holds the open clips with the end of their subtree, the clip a widget is
+// drawn with is ui_state->clip. Widgets outside of it push no instances, and a clip widget that
+// is not visible at all skips its subtree.
 root_function void
-UI_Widget_SizeAndRelativePositionCalculate(GlyphAtlas* glyphAtlas, UI_State* ui_state)
+UI_Widget_DrawPrepare(Arena* arena, UI_State* ui_state, F32Vec4 viewport)
 {
-    UI_Widget* leftMostWidget = UI_Widget_TreeLeftMostFind(ui_state->root);
-    // size and relative position calculation
-    for (UI_Widget* widget = leftMostWidget; !UI_Widget_IsEmpty(widget);
-         widget = UI_Widget_DepthFirstPostOrder(widget))
+    UI_LayoutTree* layout = &ui_state->layout;
+    // widgets in a skipped subtree keep the empty rect they start with
+    layout->visible = PushArrayZero(arena, F32Vec4, layout->count);
+    F32Vec4* clipStack = PushArray(arena, F32Vec4, layout->count + 1);
+    u32* clipEnd = PushArray(arena, u32, layout->count + 1);
+    u32 clipDepth = 0;
+    clipStack[0] = viewport;
+    clipEnd[0] = layout->count;
+    u32 culledCount = 0;
+
+    for (u32 index = 0; index < layout->count;)
     {
-        widget->computedSize = {0.0f, 0.0f};
-        widget->computedRelativePosition = {0.0f, 0.0f};
-
-        if (widget->semanticSize[Axis2_X].kind == UI_SizeKind_TextContent ||
-            widget->semanticSize[Axis2_Y].kind == UI_SizeKind_TextContent)
+        while (index >= clipEnd[clipDepth])
         {
-            Vec2<f32> text_size = widget->text_ext->size_calc_func(widget);
-            widget->computedSize = text_size;
+            clipDepth--;
         }
-
-        for (u32 axis = 0; axis < Axis2_COUNT; axis++)
+        UI_Widget* widget = layout->widget[index];
+        F32Vec4 clip = clipStack[clipDepth];
+        F32Vec4 visible = UI_RectIntersect(layout->rect[index], clip);
+        layout->visible[index] = visible;
+        b32 culled = UI_RectIsEmpty(visible);
+        if (culled && (widget->flags & UI_WidgetFlag_Clip))
         {
-            switch(widget->semanticSize[axis].kind) {
-
-                case UI_SizeKind_ChildrenSum:
-                {
-                    for (UI_Widget* child = widget->first; !UI_Widget_IsEmpty(child); child = child->next)
-                    {
-                        child->computedRelativePosition[axis] = widget->computedSize[axis];
-                        widget->computedSize[axis] += child->computedSize[axis];
-                    }
-
-                } break;
-                case UI_SizeKind_Pixels: 
-                {
-                    widget->computedSize[axis] = widget->semanticSize[axis].value;
-                } break;
-                case UI_SizeKind_Null:
-                {
-                    for (UI_Widget* child = widget->first; !UI_Widget_IsEmpty(child); child = child->next)
-                    {
-                        widget->computedSize[axis] =
-                            Max(widget->computedSize[axis], child->computedSize[axis]);
-                    }
-                } break;
-            }
-
-        }
-    }
-}
-
-root_function f32 ResizeChildren(UI_Widget* widget, Axis2 axis, f32 AxChildSizeCum, UI_Size parentSemanticSizeInfo, b32 useStrictness) {
-    b32 resizingDone = 0;
-    f32 strictness = 0;
-    f32 sizeCum = AxChildSizeCum;
-    for (UI_Widget* child = widget->last; !UI_Widget_IsEmpty(child); child = child->prev) {
-        UI_Size childSemanticSizeInfo = child->semanticSize[axis];
-        if (useStrictness) {
-            strictness = childSemanticSizeInfo.strictness;
-        }
-        sizeCum -= Max(child->computedSize[axis] - strictness, 0);
-        child->computedSize[axis] = strictness;
-        f32 sizeDiff = parentSemanticSizeInfo.value - sizeCum;
-        if (sizeDiff >= 0) {
-            sizeCum += sizeDiff;
-            child->computedSize[axis] += sizeDiff;
-            resizingDone=1;
-            break;
+            culledCount += layout->subtreeSize[index];
+            index += layout->subtreeSize[index];
+            continue;
         }
-    }
-    return sizeCum;
-}
-
-root_function void ReassignRelativePositionsOfChildren(UI_Widget* widget, Axis2 axis) {
-    f32 sizeCum = 0;
-    for (UI_Widget* child = widget->first; !UI_Widget_IsEmpty(child); child = child->next) {
-        child->computedRelativePosition[axis] = sizeCum;
-        sizeCum += child->computedSize[axis];
-    }
-}
 
-root_function void
-UI_Widget_AbsolutePositionCalculate(UI_State* ui_state, F32Vec4 posAbs)
-{
-    for (UI_Widget* widget = ui_state->root; !UI_Widget_IsEmpty(widget);
-         widget = UI_Widget_DepthFirstPreOrder(widget))
-    {
-        widget->rect = {0};
-
-        F32Vec4 rectParent = posAbs;
-        if (widget != ui_state->root)
+        if (culled)
         {
-            rectParent = widget->parent->rect;
+            culledCount++;
         }
-
-        for (u32 axis = 0; axis < Axis2_COUNT; axis++) {
-            UI_Size semanticSizeInfo = widget->semanticSize[axis];
-            switch (semanticSizeInfo.kind) {
-                case UI_SizeKind_Pixels:{
-                    f32 childAxSizeTotal = 0;
-                    for (UI_Widget* child = widget->first; !UI_Widget_IsEmpty(child); child = child->next) {
-                        childAxSizeTotal += child->computedSize[axis];
-                    }
-                    if (childAxSizeTotal > semanticSizeInfo.value) {
-                        b32 useStrictness = 1;
-                        
-                        f32 sizeAfterStrictnessResize = ResizeChildren(widget,(Axis2)axis, childAxSizeTotal, semanticSizeInfo, useStrictness); 
-                        if (sizeAfterStrictnessResize > semanticSizeInfo.value) {
-                            useStrictness = 0;
-                            ResizeChildren(widget,(Axis2)axis, sizeAfterStrictnessResize, semanticSizeInfo, useStrictness); 
-                        }
-                    }
-                    ReassignRelativePositionsOfChildren(widget, (Axis2)axis);
-                } break;
-                case UI_SizeKind_PercentOfParent: {
-                    ASSERT(0.0f <= semanticSizeInfo.value && semanticSizeInfo.value <= 1.0f, "Semantic value must be a value between 0 and 1");
-                    f32 parentSize = rectParent.point.p1[axis] - rectParent.point.p0[axis];
-                    widget->computedSize[axis] = parentSize * semanticSizeInfo.value;
-                    f32 computedRelativePosition = {0};
-                    if(!UI_Widget_IsEmpty(widget->prev)) {
-                        computedRelativePosition = widget->prev->computedRelativePosition[axis] + widget->prev->computedSize[axis]; 
-                    }
-                    widget->computedRelativePosition[axis] = computedRelativePosition;
-                } break;
-                case UI_SizeKind_Null:
-                {
-                    u32 otherAx = (axis + 1) % Axis2_COUNT;
-                    if (widget->semanticSize[otherAx].kind == UI_SizeKind_PercentOfParent) {
-                        widget->computedSize[axis] = rectParent.point.p1[axis] - rectParent.point.p0[axis];
-                    }
-                } break;
+        else
+        {
+            ui_state->clip = clip;
+            if (widget->flags & UI_WidgetFlag_DrawBackground)
+            {
+                widget->rect_ext->draw_func(widget);
             }
-        }
-
-        widget->rect.point.p0 =
-            widget->computedRelativePosition + rectParent.point.p0;
-        widget->rect.point.p1 = widget->rect.point.p0 + widget->computedSize;
-    }
-}
 
-root_function void
-UI_Widget_DrawPrepare(Arena* arena, UI_State* ui_state, BoxContext* box_context)
-{
-    for (UI_Widget* widget = ui_state->root; !UI_Widget_IsEmpty(widget);
-         widget = UI_Widget_DepthFirstPreOrder(widget))
-    {
-        if (widget->flags & UI_WidgetFlag_DrawBackground)
-        {
-            widget->rect_ext->draw_func(widget);
+            if (widget->flags & UI_WidgetFlag_DrawText)
+            {
+                widget->text_ext->draw_func(widget);
+            }
         }
 
-        if (widget->flags & UI_WidgetFlag_DrawText)
+        if (widget->flags & UI_WidgetFlag_Clip)
         {
-            widget->text_ext->draw_func(widget);
+            clipDepth++;
+            clipStack[clipDepth] = visible;
+            clipEnd[clipDepth] = index + layout->subtreeSize[index];
         }
+        index++;
     }
+    TracyPlot("widgets culled", (int64_t)culledCount);
 }
 
 // layout
@@ -322,11 +237,32 @@ UI_PopLayout()
 }
 
 inline_function void
-UI_State_FrameReset(UI_State* ui_state)
+UI_State_FrameReset(UI_State* ui_state, u32 frame_index)
 {
     ui_state->current = g_ui_widget;
     ui_state->root = g_ui_widget;
-    ArenaReset(ui_state->arena_frame);
+    ui_state->frameCount++;
+    ui_state->frameWidgetCount = 0;
+    ui_state->layout = {};
+    UI_ConfigReset(&ui_state->cfg_stacks);
+    UI_StyleTable_FrameReset(&ui_state->styleTable, UI_State::STYLE_TABLE_RESET_COUNT);
+    // the caller has waited on the fence of frame_index, so its arena is no longer read
+    Arena* arena = ui_state->arena_frames[frame_index];
+    ui_state->arena_frame = arena;
+    ArenaFrameReset(arena);
+    ArenaRegistryFrameEnd();
+    TracyPlot("arena_frame commits", (int64_t)arena->cmtCallsLastFrame);
+    TracyPlot("arena_frame decommits", (int64_t)arena->decmtCallsLastFrame);
+
+    HashMap<u64, UI_Widget*>* widgetMap = &ui_state->widgetMap;
+    HashMapRehashStep(widgetMap, UI_State::WIDGET_CACHE_REHASH_STEP);
+    HashMapProbeStats* probeStats = &widgetMap->probeStats;
+    TracyPlot("widget cache count", (int64_t)HashMapCount(widgetMap));
+    TracyPlot("widget cache capacity", (int64_t)widgetMap->table.capacity);
+    TracyPlot("widget cache probe mean",
+              probeStats->lookups ? (f64)probeStats->probeTotal / (f64)probeStats->lookups : 0.0);
+    TracyPlot("widget cache probe max", (int64_t)probeStats->probeMax);
+    *probeStats = {};
 }
 
 // Text Extensions ---------------------------------------------------------------
@@ -335,33 +271,49 @@ root_function Vec2<f32>
 UI_TextExtSizeCalc(UI_Widget* widget) {
     GlyphAtlas* glyphAtlas = GlobalContextGet()->glyphAtlas;
     UI_TextExtData* data = (UI_TextExtData*)widget->text_ext->data;
-    Font* font = FontFindOrCreate(glyphAtlas, data->font_size);
-    Vec2<f32> text_size = TextDimensionsCalculate(font, data->text);
+    UI_Style* style = UI_Style_FromId(&GlobalContextGet()->ui_state->styleTable, widget->style);
+    Font* font = FontFindOrCreate(glyphAtlas, style->font_size);
+    TextRun* run = TextRunFindOrCreate(glyphAtlas, font, data->text);
+    Vec2<f32> text_size = run ? run->dimensions : TextDimensionsCalculate(font, data->text);
     data->text_size = text_size;
+    widget->layoutCache.textSize = text_size;
 
-    f32 padding_width = data->padding.point.p0.x + data->padding.point.p1.x;
-    f32 padding_height = data->padding.point.p0.y + data->padding.point.p1.y;
+    f32 padding_width = style->padding.point.p0.x + style->padding.point.p1.x;
+    f32 padding_height = style->padding.point.p0.y + style->padding.point.p1.y;
     Vec2<f32> padding_size = {padding_width, padding_height};
 
-    f32 margin_width = data->margin.point.p0.x + data->margin.point.p1.x;
-    f32 margin_height = data->margin.point.p0.y + data->margin.point.p1.y;
+    f32 margin_width = style->margin.point.p0.x + style->margin.point.p1.x;
+    f32 margin_height = style->margin.point.p0.y + style->margin.point.p1.y;
     Vec2<f32> margin_size = {margin_width, margin_height};
 
-    return data->text_size + 2.f*data->border_thickness + padding_size + margin_size;
+    return data->text_size + 2.f*style->border_thickness + padding_size + margin_size;
 }
 
 root_function void
 UI_TextExtDraw(UI_Widget* widget) {
     GlyphAtlas* glyphAtlas = GlobalContextGet()->glyphAtlas;
+    UI_State* ui_state = GlobalContextGet()->ui_state;
     UI_TextExtData* data = (UI_TextExtData*)widget->text_ext->data;
+    UI_Style* style = UI_Style_FromId(&ui_state->styleTable, widget->style);
     Vec2 diff_dim = widget->rect.point.p1 - widget->rect.point.p0 - data->text_size;
     Vec2 glyph_pos = widget->rect.point.p0 + diff_dim / 2.0f;
-    Vec2 p0xB = widget->rect.point.p0 + data->border_thickness + data->padding.point.p0 + data->margin.point.p0;
-    Vec2 p1xB = widget->rect.point.p1 - data->border_thickness - data->padding.point.p1 - data->margin.point.p1;
+    Vec2 p0xB = widget->rect.point.p0 + style->border_thickness + style->padding.point.p0 + style->margin.point.p0;
+    Vec2 p1xB = widget->rect.point.p1 - style->border_thickness - style->padding.point.p1 - style->margin.point.p1;
 
-    Font *font = FontFindOrCreate(glyphAtlas, data->font_size);
+    Font *font = FontFindOrCreate(glyphAtlas, style->font_size);
 
-    TextDraw(font, data->text, p0xB, p1xB);
+    u64 instanceOffset = font->instances.count;
+    TextRun* run = TextRunFindOrCreate(glyphAtlas, font, data->text);
+    if (run)
+    {
+        TextRunDraw(font, run, p0xB, p1xB);
+    }
+    else
+    {
+        TextDraw(font, data->text, p0xB, p1xB);
+    }
+    ScissorBatchPush(&font->batches, ui_state->clip, instanceOffset,
+                     font->instances.count - instanceOffset);
 } 
 
 root_function void 
@@ -370,13 +322,10 @@ UI_Widget_TextExtAdd(UI_Widget* widget, UI_TextExtSizeCalcFuncType* size_calc_fu
     UI_State* ui_state = GlobalContextGet()->ui_state;
     Arena* arena = ui_state->arena_frame;
 
-    u32 font_size = C_FontSize_Get();
-    String8 text = C_Text_Get();
-    f32 border_thickness = C_BorderThickness_Get();
-    F32Vec4 padding = C_Padding_Get();
-    F32Vec4 margin = C_Margin_Get();
     UI_TextExtData* data = PushStruct(arena, UI_TextExtData);
-    *data = {.font_size=font_size, .text=text, .border_thickness=border_thickness, .padding=padding, .margin=margin};
+    *data = {.text=C_Text_Get()};
+    // last measurement, layout only measures again when the text inputs change
+    data->text_size = widget->layoutCache.textSize;
 
     UI_TextExt* text_ext = PushStruct(arena, UI_TextExt);
     text_ext->data = data;
@@ -388,20 +337,19 @@ UI_Widget_TextExtAdd(UI_Widget* widget, UI_TextExtSizeCalcFuncType* size_calc_fu
 // Rect extension ----------------------------------------------------------------
 root_function void
 UI_Widget_RectExtDraw(UI_Widget* widget) {
-    UI_RectExtData* data = (UI_RectExtData*)widget->rect_ext->data;
     Context* ctx = GlobalContextGet();
-    Arena* frame_arena = ctx->ui_state->arena_frame;
+    UI_Style* style = UI_Style_FromId(&ctx->ui_state->styleTable, widget->style);
     BoxContext* box_context = ctx->box_context;
-    Box* box = PushStructZero(frame_arena, Box);
-    QueuePush(box_context->boxQueue.first, box_context->boxQueue.last, box);
+    ScissorBatchPush(&box_context->batches, ctx->ui_state->clip, box_context->boxes.count, 1);
+    Vulkan_BoxInstance* box = ChunkListPushZero(&box_context->boxes);
 
     // reacting to last frame input
-    box->pos0 = widget->rect.point.p0 + data->margin.point.p0;
-    box->pos1 = widget->rect.point.p1 - data->margin.point.p1;
-    box->color = data->background_color;
-    box->softness = data->softness;
-    box->borderThickness = data->border_thickness;
-    box->cornerRadius = data->corner_radius;
+    box->pos0 = widget->rect.point.p0 + style->margin.point.p0;
+    box->pos1 = widget->rect.point.p1 - style->margin.point.p1;
+    box->color = style->background_color;
+    box->softness = style->softness;
+    box->borderThickness = style->border_thickness;
+    box->cornerRadius = style->corner_radius;
     box->attributes = 0;
 
     if (widget->flags & UI_WidgetFlag_Clickable)
@@ -423,47 +371,37 @@ UI_Widget_RectExtAdd(UI_Widget* widget, UI_RectExtDrawFuncType* draw_func) {
     UI_State* ui_state = GlobalContextGet()->ui_state;
     Arena* arena = ui_state->arena_frame;
 
-    F32Vec4 color = C_BackgroundColor_Get();
-    f32 softness = C_Softness_Get();
-    f32 border_thickness = C_BorderThickness_Get();
-    f32 corner_radius = C_CornerRadius_Get();
-    F32Vec4 margin = C_Margin_Get();
-    UI_RectExtData* data = PushStruct(arena, UI_RectExtData);
-    *data = {
-            .background_color=color, 
-            .softness=softness,
-            .border_thickness=border_thickness, 
-            .corner_radius=corner_radius, 
-            .margin=margin
-        };
-
     UI_RectExt* rect_ext = PushStruct(arena, UI_RectExt);
-    rect_ext->data = data;
     rect_ext->draw_func = draw_func;
     widget->rect_ext = rect_ext;
 }
 
 // Root Functions ----------------------------------------------------------------
+// Takes the final key, already combined with the parent's. The UI_Widget_Add overloads derive it.
 root_function void
-UI_Widget_Add(String8 widgetName, UI_WidgetFlags flags,
-                UI_Size semanticSizeX, UI_Size semanticSizeY)
+UI_Widget_AddWithKey(UI_Key key, String8 widgetName, UI_WidgetFlags flags, UI_Size semanticSizeX,
+                     UI_Size semanticSizeY)
 {
-    Context* context = GlobalContextGet();
-    UI_State* ui_state = context->ui_state;
-    UI_IO* io = context->io;
-    GlyphAtlas* glyphAtlas = context->glyphAtlas;
+    UI_State* ui_state = GlobalContextGet()->ui_state;
 
-    UI_Key key = UI_Key_Calculate(widgetName);
     UI_Widget* widget = UI_Widget_FromKey(ui_state, key);
-    
+    UI_Widget_Touch(ui_state, widget);
     UI_Widget_TreeStateReset(widget);
+    ui_state->frameWidgetCount++;
 
     widget->name = widgetName;
     widget->flags = flags;
-    widget->active_t = false;
-    widget->hot_t = false;
+    widget->hot_t = UI_Key_IsEqual(key, ui_state->hotKey);
+    widget->active_t = UI_Key_IsEqual(key, ui_state->activeKey);
     widget->semanticSize[Axis2_X] = semanticSizeX;
     widget->semanticSize[Axis2_Y] = semanticSizeY;
+    widget->childLayoutAxis = C_ChildLayoutAxis_Get();
+    widget->childOffset = {0.0f, 0.0f};
+
+    if (flags & (UI_WidgetFlag_DrawBackground | UI_WidgetFlag_DrawText))
+    {
+        widget->style = UI_Style_FromConfig(&ui_state->styleTable);
+    }
 
     if (flags & UI_WidgetFlag_DrawBackground) {
         UI_Widget_RectExtAdd(widget, UI_Widget_RectExtDraw);
@@ -473,15 +411,6 @@ UI_Widget_Add(String8 widgetName, UI_WidgetFlags flags,
         UI_Widget_TextExtAdd(widget, UI_TextExtSizeCalc, UI_TextExtDraw);
     }
 
-    if (io->mousePosition >= widget->rect.point.p0 && io->mousePosition <= widget->rect.point.p1)
-    {
-        widget->hot_t = true;
-        if (io->leftClicked)
-        {
-            widget->active_t = true;
-        }
-    }
-
     UI_Widget* parent = C_Parent_Get();
     if (!UI_Widget_IsEmpty(parent))
     {
@@ -494,4 +423,33 @@ UI_Widget_Add(String8 widgetName, UI_WidgetFlags flags,
 
     widget->parent = parent;
     ui_state->current = widget;
+    UI_ConfigAutoPop(&ui_state->cfg_stacks);
+}
+
+root_function void
+UI_Widget_Add(String8 widgetName, UI_WidgetFlags flags,
+                UI_Size semanticSizeX, UI_Size semanticSizeY)
+{
+    UI_Key key = UI_Key_Calculate(C_Parent_Get()->key, widgetName);
+    UI_Widget_AddWithKey(key, widgetName, flags, semanticSizeX, semanticSizeY);
+}
+
+// Keyed by a precomputed key local to the parent, e.g. from UI_KeyLit, so building the widget
+// does no hashing or formatting beyond one mix with the parent key.
+root_function void
+UI_Widget_Add(UI_Key localKey, UI_WidgetFlags flags, UI_Size semanticSizeX,
+              UI_Size semanticSizeY)
+{
+    UI_Key key = UI_Key_Calculate(C_Parent_Get()->key, localKey);
+    String8 widgetName = {};
+    UI_Widget_AddWithKey(key, widgetName, flags, semanticSizeX, semanticSizeY);
+}
+
+// Keyed by an integer, e.g. a loop index, without formatting a name.
+root_function void
+UI_Widget_Add(u64 id, UI_WidgetFlags flags, UI_Size semanticSizeX, UI_Size semanticSizeY)
+{
+    UI_Key key = UI_Key_Calculate(C_Parent_Get()->key, id);
+    String8 widgetName = {};
+    UI_Widget_AddWithKey(key, widgetName, flags, semanticSizeX, semanticSizeY);
 }
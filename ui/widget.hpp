@@ -8,6 +8,37 @@
 root_function UI_Key
 UI_Key_Calculate(String8 str);
 
+root_function UI_Key
+UI_Key_Calculate(UI_Key seed, String8 str);
+
+root_function UI_Key
+UI_Key_Calculate(UI_Key seed, u64 id);
+
+root_function UI_Key
+UI_Key_Calculate(UI_Key seed, UI_Key local);
+
+// Key of a string literal, hashed at compile time. Combine it with an index at runtime through
+// UI_Key_Calculate(UI_KeyLit("row"), row_i). Not equal to the key of the same name as String8.
+consteval UI_Key
+UI_Key_FromLiteral(const char* str, u64 size)
+{
+    // FNV-1a followed by the murmur3 finalizer
+    u64 hash = 0xcbf29ce484222325ULL;
+    for (u64 i = 0; i < size; i++)
+    {
+        hash ^= (u8)str[i];
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return UI_Key{hash ? hash : 1};
+}
+
+#define UI_KeyLit(str) UI_Key_FromLiteral((str), sizeof(str) - 1)
+
 root_function bool
 UI_Key_IsEqual(UI_Key key0, UI_Key key1);
 
@@ -22,34 +53,33 @@ UI_Widget_FromKey(UI_State* ui_state, UI_Key key);
 root_function UI_Widget*
 UI_Widget_Allocate(UI_State* ui_state);
 
-root_function UI_Widget*
-UI_WidgetSlot_Push(UI_State* ui_state, UI_Key key);
-
-// Widget functions
-root_function f32 
-ResizeChildren(UI_Widget* widget, Axis2 axis, f32 AxChildSizeCum, UI_Size parentSemanticSizeInfo, b32 useStrictness);
+root_function void
+UI_Widget_Touch(UI_State* ui_state, UI_Widget* widget);
 
-root_function void 
-ReassignRelativePositionsOfChildren(UI_Widget* widget, Axis2 axis);
+root_function void
+UI_Widget_Prune(UI_State* ui_state);
 
+// Widget functions
 root_function void
 UI_Widget_Add(String8 widgetName, UI_WidgetFlags flags,
             UI_Size semanticSizeX, UI_Size semanticSizeY);
 
 root_function void
-UI_Widget_SizeAndRelativePositionCalculate(GlyphAtlas* glyphAtlas, UI_State* ui_state);
-
-root_function UI_Widget*
-UI_Widget_DepthFirstPreOrder(UI_Widget* widget);
+UI_Widget_AddWithKey(UI_Key key, String8 widgetName, UI_WidgetFlags flags, UI_Size semanticSizeX,
+                     UI_Size semanticSizeY);
 
-inline_function UI_Widget*
-UI_Widget_TreeLeftMostFind(UI_Widget* root);
+root_function void
+UI_Widget_Add(UI_Key localKey, UI_WidgetFlags flags, UI_Size semanticSizeX,
+              UI_Size semanticSizeY);
 
 root_function void
-UI_Widget_AbsolutePositionCalculate(UI_State* ui_state, F32Vec4 posAbs);
+UI_Widget_Add(u64 id, UI_WidgetFlags flags, UI_Size semanticSizeX, UI_Size semanticSizeY);
+
+root_function UI_Widget*
+UI_Widget_DepthFirstPreOrder(UI_Widget* widget);
 
 root_function void
-UI_Widget_DrawPrepare(Arena* arena, UI_State* ui_state, BoxContext* box_context);
+UI_Widget_DrawPrepare(Arena* arena, UI_State* ui_state, F32Vec4 viewport);
 
 // Layout functions
 inline_function void
@@ -61,7 +91,7 @@ UI_PopLayout();
 #define UI_Layout_Scoped DeferScoped(UI_PushLayout(), UI_PopLayout()) 
 
 inline_function void
-UI_State_FrameReset(UI_State* ui_state);
+UI_State_FrameReset(UI_State* ui_state, u32 frame_index);
 
 root_function Vec2<f32>
 UI_TextExtSizeCalc(UI_Widget* widget);